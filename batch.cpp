@@ -0,0 +1,267 @@
+/*
+ * Description: 离线批量评估，清单里每行一个比赛格式的输入文件（网络加所有场景的断边序列），
+ * 每个线程一个引擎并行跑，输出每个输入和汇总的分数、耗时、每小时场景数
+ * 用法：batch 清单文件 [-j 线程数] [-t 每个输入的时间限制ms] [-c 通道数] [-s] [-d 引擎线程数]
+ * -s 先生成自己的样例，像判题器一样替换前面的场景；默认不生成，直接跑文件里的场景
+ * -c 输入格式里没有通道数，默认40
+ * -d 不跑场景，每个输入分别用1个和这么多个线程初始化，比较初始化结果的哈希和用时，检查并行归约的顺序
+ *    和线程数无关；变通道能力局部搜索受时间影响，这时关掉，候选路径按第一次建的个数建。
+ *    输入一个一个跑，哈希不一样返回1
+ */
+#include "routing_api.h"
+#include "protocol.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+struct BatchOptions {
+    string manifestPath;
+    int workerCount = 0;//0表示按核数
+    int timeLimit = 10 * 1000;//每个输入整个流程的时间
+    int channelCount = 40;
+    bool withSamples = false;
+    int checkThreadCount = 0;//大于0是检查模式
+};
+
+struct BatchResult {
+    string path;
+    bool ok = false;
+    int sceneCount = 0;
+    int sampleCount = 0;
+    long long eventCount = 0;
+    double score = 0;//所有场景得分和，每个场景满分10000
+    double elapsed = 0;//秒
+};
+
+static double secondsSince(chrono::steady_clock::time_point startTime) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - startTime).count() / 1e6;
+}
+
+static bool parseOptions(int argc, char **argv, BatchOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            options.workerCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            options.timeLimit = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            options.channelCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            options.withSamples = true;
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            options.checkThreadCount = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && options.manifestPath.empty()) {
+            options.manifestPath = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return !options.manifestPath.empty() && options.timeLimit > 0;
+}
+
+//空行和#开头的行跳过，相对路径按清单所在目录
+static bool readManifest(const string &manifestPath, vector<string> &paths) {
+    FILE *file = fopen(manifestPath.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    size_t slash = manifestPath.find_last_of('/');
+    string baseDir = slash == string::npos ? "" : manifestPath.substr(0, slash + 1);
+    char line[4096];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        string path = line;
+        path.erase(0, path.find_first_not_of(" \t\r\n"));
+        path.erase(path.find_last_not_of(" \t\r\n") + 1);
+        if (path.empty() || path[0] == '#') {
+            continue;
+        }
+        paths.push_back(path[0] == '/' ? path : baseDir + path);
+    }
+    fclose(file);
+    return true;
+}
+
+static BatchResult runOne(const string &path, const BatchOptions &options) {
+    BatchResult result;
+    result.path = path;
+    auto startTime = chrono::steady_clock::now();
+    NetworkInput input;
+    vector<vector<int>> scenarios;
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return result;
+    }
+    bool parsed = readNetwork(file, input) && readScenarios(file, scenarios);
+    fclose(file);
+    if (!parsed) {
+        return result;
+    }
+    input.channelCount = options.channelCount;
+    //引擎建好就开始计时，和比赛一样读输入也算在时间里
+    EngineOptions engineOptions;
+    engineOptions.timeLimit = options.timeLimit;
+    engineOptions.threadCount = 1;
+    RoutingEngine engine(engineOptions);
+    if (!engine.loadNetwork(input)) {
+        return result;
+    }
+    if (options.withSamples) {
+        SampleSet sampleSet = engine.generateSamples();
+        result.sampleCount = int(min(sampleSet.samples.size(), scenarios.size()));
+        for (int i = 0; i < result.sampleCount; i++) {
+            scenarios[i] = sampleSet.samples[i];
+        }
+    }
+    engine.beginScenarios(int(scenarios.size()));
+    for (const vector<int> &scenario: scenarios) {
+        engine.beginScenario();
+        for (int failEdgeId: scenario) {
+            engine.failEdge(failEdgeId);
+        }
+        result.eventCount += scenario.size();
+        result.score += engine.endScenario();
+    }
+    result.sceneCount = int(scenarios.size());
+    result.elapsed = secondsSince(startTime);
+    result.ok = true;
+    return result;
+}
+
+//用threadCount个线程初始化一次，返回初始化结果的哈希，读不了或者不支持返回false
+//candidateRouteBusinessCount为-1按时间建候选路径，建了多少写回去
+static bool initHash(const string &path, const BatchOptions &options, int threadCount,
+                     int &candidateRouteBusinessCount, unsigned long long &hash, double &elapsed) {
+    NetworkInput input;
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+    bool parsed = readNetwork(file, input);
+    fclose(file);
+    if (!parsed) {
+        return false;
+    }
+    input.channelCount = options.channelCount;
+    EngineOptions engineOptions;
+    engineOptions.timeLimit = options.timeLimit;
+    engineOptions.threadCount = threadCount;
+    engineOptions.capabilitySearch = false;
+    engineOptions.candidateRouteBusinessCount = candidateRouteBusinessCount;
+    auto startTime = chrono::steady_clock::now();
+    RoutingEngine engine(engineOptions);
+    if (!engine.loadNetwork(input)) {
+        return false;
+    }
+    elapsed = secondsSince(startTime);
+    hash = engine.getInitHash();
+    candidateRouteBusinessCount = engine.getCandidateRouteBusinessCount();
+    return true;
+}
+
+static int checkInit(const vector<string> &paths, const BatchOptions &options) {
+    int failed = 0;
+    for (const string &path: paths) {
+        unsigned long long hashes[2];
+        double times[2];
+        int threadCounts[2] = {1, options.checkThreadCount};
+        //候选路径按时间建，第二次按第一次建的个数建
+        int candidateRouteBusinessCount = -1;
+        bool ok = true;
+        for (int k = 0; k < 2 && ok; k++) {
+            ok = initHash(path, options, threadCounts[k], candidateRouteBusinessCount, hashes[k], times[k]);
+        }
+        if (!ok) {
+            printf("FAIL %s\n", path.c_str());
+            failed++;
+        } else {
+            bool same = hashes[0] == hashes[1];
+            failed += !same;
+            printf("%s %s threads:%d hash:%016llx time:%.3fs threads:%d hash:%016llx time:%.3fs\n", path.c_str(),
+                   same ? "SAME" : "DIFF", threadCounts[0], hashes[0], times[0], threadCounts[1], hashes[1],
+                   times[1]);
+        }
+        fflush(stdout);
+    }
+    printf("checked inputs:%d failed:%d\n", int(paths.size()), failed);
+    return failed == 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    BatchOptions options;
+    vector<string> paths;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "usage: %s manifest [-j workers] [-t timeLimitMs] [-c channels] [-s] [-d threads]\n",
+                argv[0]);
+        return 2;
+    }
+    if (!readManifest(options.manifestPath, paths)) {
+        fprintf(stderr, "cannot read manifest %s\n", options.manifestPath.c_str());
+        return 2;
+    }
+    if (options.checkThreadCount > 0) {
+        return checkInit(paths, options);
+    }
+    int workerCount = options.workerCount > 0 ? options.workerCount : int(thread::hardware_concurrency());
+    workerCount = max(1, min(workerCount, int(paths.size())));
+
+    //每个线程一个引擎，做完一个取下一个，完成一个打印一行
+    auto startTime = chrono::steady_clock::now();
+    vector<BatchResult> results(paths.size());
+    atomic<int> nextIndex(0);
+    mutex printLock;
+    vector<thread> workers;
+    for (int w = 0; w < workerCount; w++) {
+        workers.emplace_back([&]() {
+            while (true) {
+                int index = nextIndex++;
+                if (index >= int(paths.size())) {
+                    return;
+                }
+                results[index] = runOne(paths[index], options);
+                const BatchResult &r = results[index];
+                lock_guard<mutex> guard(printLock);
+                if (!r.ok) {
+                    printf("FAIL %s\n", r.path.c_str());
+                } else {
+                    printf("%s scenes:%d samples:%d events:%lld score:%.2f avg:%.2f time:%.2fs\n", r.path.c_str(),
+                           r.sceneCount, r.sampleCount, r.eventCount, r.score, r.score / max(1, r.sceneCount),
+                           r.elapsed);
+                }
+                fflush(stdout);
+            }
+        });
+    }
+    for (thread &worker: workers) {
+        worker.join();
+    }
+    double wallTime = secondsSince(startTime);
+
+    int okCount = 0;
+    int sceneCount = 0;
+    long long eventCount = 0;
+    double score = 0;
+    double busyTime = 0;
+    for (const BatchResult &r: results) {
+        if (!r.ok) {
+            continue;
+        }
+        okCount++;
+        sceneCount += r.sceneCount;
+        eventCount += r.eventCount;
+        score += r.score;
+        busyTime += r.elapsed;
+    }
+    printf("total inputs:%d/%d workers:%d scenes:%d events:%lld score:%.2f avg:%.2f\n", okCount, int(paths.size()),
+           workerCount, sceneCount, eventCount, score, score / max(1, sceneCount));
+    printf("time wall:%.2fs busy:%.2fs scenesPerHour:%.0f eventsPerHour:%.0f\n", wallTime, busyTime,
+           sceneCount * 3600.0 / max(wallTime, 1e-6), eventCount * 3600.0 / max(wallTime, 1e-6));
+    return okCount == int(paths.size()) ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+/*
+ * Description: 比赛输入格式解析，标准输入和批量跑的输入文件共用
+ */
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include "routing_api.h"
+#include <cstdio>
+
+//读网络和业务，格式错误返回false
+inline bool readNetwork(FILE *file, NetworkInput &input) {
+    int N, M;
+    if (fscanf(file, "%d %d", &N, &M) != 2) {
+        return false;
+    }
+    input.vertexCount = N;
+    input.changeCounts.resize(N);
+    for (int i = 0; i < N; i++) {
+        if (fscanf(file, "%d", &input.changeCounts[i]) != 1) {
+            return false;
+        }
+    }
+    input.edges.resize(M);
+    for (int i = 0; i < M; i++) {
+        if (fscanf(file, "%d %d", &input.edges[i].from, &input.edges[i].to) != 2) {
+            return false;
+        }
+    }
+    int J;
+    if (fscanf(file, "%d", &J) != 1) {
+        return false;
+    }
+    input.businesses.resize(J);
+    for (int i = 0; i < J; i++) {
+        NetworkBusiness &business = input.businesses[i];
+        int S;
+        if (fscanf(file, "%d %d %d %d %d %d", &business.from, &business.to, &S, &business.startChannel,
+                   &business.endChannel, &business.value) != 6) {
+            return false;
+        }
+        business.edgeIds.resize(S);
+        for (int j = 0; j < S; j++) {
+            if (fscanf(file, "%d", &business.edgeIds[j]) != 1) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//一次读完所有场景的断边序列，每个场景以-1结束，只有离线批量跑用
+inline bool readScenarios(FILE *file, std::vector<std::vector<int>> &scenarios) {
+    int T;
+    if (fscanf(file, "%d", &T) != 1) {
+        return false;
+    }
+    scenarios.assign(T, {});
+    for (int i = 0; i < T; i++) {
+        while (true) {
+            int failEdgeId;
+            if (fscanf(file, "%d", &failEdgeId) != 1) {
+                return false;
+            }
+            if (failEdgeId == -1) {
+                break;
+            }
+            scenarios[i].push_back(failEdgeId);
+        }
+    }
+    return true;
+}
+
+#endif //PROTOCOL_H
@@ -0,0 +1,171 @@
+/*
+ * Description: 离线重放线上记录，按记录的变通道能力、样例和每条断边的决定重跑线上阶段，没有时间限制，
+ * 每条断边的输出和记录对比，输出不一致的断边、随机数状态对不上的场景和最慢的几条断边
+ * 用法：replay 记录文件 [-u 断边序号] [-k 个数] [-n]
+ * -u 重放到这条断边(从0数，所有场景连起来)就停，单独分析一条慢的断边时用
+ * -k 最后列出最慢的几条，默认10
+ * -n 关掉增量搜索，重排次数照记录的来，和不加-n比总用时看增量搜索值不值；代价相同的路径选法不一样，
+ *    输出对不上是正常的
+ */
+#include "routing_api.h"
+#include "trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+struct ReplayOptions {
+    string tracePath;
+    long long untilEvent = -1;//-1表示全部重放
+    int slowestCount = 10;
+    bool incrementalSearch = true;
+};
+
+struct EventTime {
+    int scene;
+    int event;
+    int failEdgeId;
+    long long recorded;//us
+    long long replayed;//us
+};
+
+static bool parseOptions(int argc, char **argv, ReplayOptions &options) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+            options.untilEvent = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            options.slowestCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-n") == 0) {
+            options.incrementalSearch = false;
+        } else if (argv[i][0] != '-' && options.tracePath.empty()) {
+            options.tracePath = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return !options.tracePath.empty();
+}
+
+//业务的顺序跟哈希表有关，按业务编号排好再比
+static bool samePlan(ReroutePlan a, ReroutePlan b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    auto byId = [](const ReroutedBusiness &x, const ReroutedBusiness &y) {
+        return x.businessId < y.businessId;
+    };
+    sort(a.begin(), a.end(), byId);
+    sort(b.begin(), b.end(), byId);
+    for (int i = 0; i < a.size(); i++) {
+        if (a[i].businessId != b[i].businessId || a[i].segments.size() != b[i].segments.size()) {
+            return false;
+        }
+        for (int j = 0; j < a[i].segments.size(); j++) {
+            const RouteSegment &x = a[i].segments[j];
+            const RouteSegment &y = b[i].segments[j];
+            if (x.edgeId != y.edgeId || x.startChannel != y.startChannel || x.endChannel != y.endChannel) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    ReplayOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        fprintf(stderr, "usage: %s trace [-u eventIndex] [-k slowestCount] [-n]\n", argv[0]);
+        return 2;
+    }
+    Trace trace;
+    if (!readTrace(options.tracePath, trace)) {
+        fprintf(stderr, "cannot read trace %s\n", options.tracePath.c_str());
+        return 2;
+    }
+    if (!trace.hasSamples) {
+        fprintf(stderr, "trace ends before samples, nothing to replay\n");
+        return 2;
+    }
+    EngineOptions engineOptions;
+    engineOptions.threadCount = 1;
+    engineOptions.replay = true;
+    engineOptions.candidateRouteBusinessCount = trace.candidateRouteBusinessCount;
+    engineOptions.incrementalSearch = options.incrementalSearch;
+    RoutingEngine engine(engineOptions);
+    if (!engine.loadNetwork(trace.input)) {
+        fprintf(stderr, "unsupported network\n");
+        return 2;
+    }
+    engine.loadSamples(trace.sampleSet);
+    engine.beginScenarios(trace.scenarioCount);
+
+    long long eventIndex = 0;
+    int mismatches = 0;
+    int stateMismatches = 0;
+    int scoreMismatches = 0;
+    vector<EventTime> times;
+    bool stopped = false;
+    for (int s = 0; s < trace.scenes.size() && !stopped; s++) {
+        const TraceScene &scene = trace.scenes[s];
+        engine.beginScenario();
+        //对不上就报出来，再按记录的接着跑，后面的场景还能对比
+        if (engine.getSearchRandomState() != scene.searchRandomState) {
+            printf("scene %d: search random state differs\n", s);
+            stateMismatches++;
+            engine.setSearchRandomState(scene.searchRandomState);
+        }
+        for (int e = 0; e < scene.events.size(); e++, eventIndex++) {
+            const TraceEvent &event = scene.events[e];
+            auto startTime = chrono::steady_clock::now();
+            ReroutePlan plan = engine.replayFailEdge(event.failEdgeId, event.decision);
+            long long elapsed = chrono::duration_cast<chrono::microseconds>(
+                    chrono::steady_clock::now() - startTime).count();
+            times.push_back({s, e, event.failEdgeId, event.elapsed, elapsed});
+            if (!samePlan(plan, event.plan)) {
+                mismatches++;
+                const char *note = event.decision.lastPassInterrupted ? " (interrupted when recorded)"
+                                   : event.decision.speculated ? " (speculated when recorded)" : "";
+                printf("scene %d event %d edge %d: plan differs, recorded %d businesses, replayed %d%s\n", s, e,
+                       event.failEdgeId, int(event.plan.size()), int(plan.size()), note);
+            }
+            if (eventIndex == options.untilEvent) {
+                printf("stopped at scene %d event %d edge %d passes:%d recorded:%.3fms replayed:%.3fms\n", s, e,
+                       event.failEdgeId, event.decision.passes, event.elapsed / 1000.0, elapsed / 1000.0);
+                stopped = true;
+                break;
+            }
+        }
+        if (!stopped && scene.finished) {
+            double score = engine.endScenario();
+            if (fabs(score - scene.score) > 1e-3) {
+                printf("scene %d: score %.3f recorded %.3f\n", s, score, scene.score);
+                scoreMismatches++;
+            }
+        }
+    }
+
+    long long recordedTime = 0;
+    long long replayedTime = 0;
+    for (const EventTime &time: times) {
+        recordedTime += time.recorded;
+        replayedTime += time.replayed;
+    }
+    printf("replayed scenes:%d events:%d planMismatches:%d stateMismatches:%d scoreMismatches:%d"
+           " recorded:%.2fs replayed:%.2fs\n", int(trace.scenes.size()), int(times.size()), mismatches,
+           stateMismatches, scoreMismatches, recordedTime / 1e6, replayedTime / 1e6);
+    sort(times.begin(), times.end(), [](const EventTime &a, const EventTime &b) {
+        return a.replayed > b.replayed;
+    });
+    for (int i = 0; i < times.size() && i < options.slowestCount; i++) {
+        const EventTime &time = times[i];
+        printf("slow scene %d event %d edge %d recorded:%.3fms replayed:%.3fms\n", time.scene, time.event,
+               time.failEdgeId, time.recorded / 1000.0, time.replayed / 1000.0);
+    }
+    return mismatches == 0 && stateMismatches == 0 && scoreMismatches == 0 ? 0 : 1;
+}
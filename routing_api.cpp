@@ -0,0 +1,151 @@
+/*
+ * Description: 路由库接口实现，转发给Strategy，设了记录文件时顺便记录
+ */
+#include "routing_api.h"
+#include "strategy.h"
+#include "trace.h"
+
+RoutingEngine::RoutingEngine(const EngineOptions &options)
+        : options(options), createTime(std::chrono::steady_clock::now()) {
+    if (!options.tracePath.empty()) {
+        trace.reset(new TraceWriter());
+        if (!trace->open(options.tracePath)) {
+            trace.reset();
+        }
+    }
+}
+
+RoutingEngine::~RoutingEngine() {
+    if (strategy) {
+        strategy->stopIdleWork();
+    }
+}
+
+//每种通道数一份内核，通道数是编译期常量
+static StrategyBase *createStrategy(int channelCount) {
+    switch (channelCount) {
+        case 40:
+            return new Strategy<40>();
+        case 64:
+            return new Strategy<64>();
+        case 80:
+            return new Strategy<80>();
+        case 96:
+            return new Strategy<96>();
+        default:
+            return nullptr;
+    }
+}
+
+bool RoutingEngine::loadNetwork(const NetworkInput &input) {
+    if (input.vertexCount >= MAX_SEARCH_ID || int(input.edges.size()) >= MAX_SEARCH_ID) {
+        return false;
+    }
+    strategy.reset(createStrategy(input.channelCount));
+    if (!strategy) {
+        return false;
+    }
+    strategy->setTimeLimit(createTime, options.timeLimit);
+    strategy->setThreadCount(options.threadCount);
+    if (options.replay) {
+        strategy->setReplay();
+    }
+    strategy->setCandidateRouteBusinessCount(options.candidateRouteBusinessCount);
+    strategy->setCapabilitySearch(options.capabilitySearch);
+    strategy->setIncrementalSearch(options.incrementalSearch);
+    //记录和重放时不用路径缓存
+    strategy->setPathCache(!trace && !options.replay);
+    strategy->init(input);
+    if (trace) {
+        trace->writeNetwork(input, strategy->getCandidateRouteBusinessCount());
+    }
+    return true;
+}
+
+SampleSet RoutingEngine::generateSamples() {
+    SampleSet result;
+    result.samples = strategy->createSamples();
+    result.changeCounts = strategy->getChangeCounts();
+    result.maxLengths = strategy->getSampleMaxLengths();
+    if (trace) {
+        trace->writeSamples(result, CREATE_SAMPLE_RANDOM_SEED, SEARCH_RANDOM_SEED);
+    }
+    return result;
+}
+
+void RoutingEngine::loadSamples(const SampleSet &sampleSet) {
+    strategy->loadSamples(sampleSet);
+}
+
+void RoutingEngine::beginScenarios(int count) {
+    strategy->beginScenarios(count);
+    if (trace) {
+        trace->writeScenarios(count);
+    }
+}
+
+void RoutingEngine::beginScenario() {
+    strategy->beginScenario();
+    if (trace) {
+        trace->writeSceneBegin(strategy->getSearchRandomState());
+    }
+}
+
+void RoutingEngine::startIdleWork() {
+    strategy->startIdleWork();
+}
+
+void RoutingEngine::stopIdleWork() {
+    strategy->stopIdleWork();
+}
+
+static ReroutePlan toPlan(const unordered_map<int, vector<Point>> &result) {
+    ReroutePlan plan;
+    for (const auto &entry: result) {
+        ReroutedBusiness business{entry.first, {}};
+        for (const Point &point: entry.second) {
+            business.segments.push_back({point.edgeId, point.startChannelId, point.endChannelId});
+        }
+        plan.push_back(std::move(business));
+    }
+    return plan;
+}
+
+ReroutePlan RoutingEngine::failEdge(int edgeId) {
+    auto startTime = std::chrono::steady_clock::now();
+    ReroutePlan plan = toPlan(strategy->failEdge(edgeId));
+    if (trace) {
+        long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - startTime).count();
+        trace->writeFailEdge(edgeId, strategy->getLastDecision(), elapsed, plan);
+    }
+    return plan;
+}
+
+ReroutePlan RoutingEngine::replayFailEdge(int edgeId, const DispatchDecision &decision) {
+    return toPlan(strategy->replayFailEdge(edgeId, decision));
+}
+
+double RoutingEngine::endScenario() {
+    double score = strategy->endScenario();
+    if (trace) {
+        trace->writeSceneEnd(score);
+    }
+    return score;
+}
+
+unsigned long long RoutingEngine::getSearchRandomState() const {
+    return strategy->getSearchRandomState();
+}
+
+void RoutingEngine::setSearchRandomState(unsigned long long state) {
+    strategy->setSearchRandomState(state);
+}
+
+unsigned long long RoutingEngine::getInitHash() const {
+    return strategy->getInitHash();
+}
+
+int RoutingEngine::getCandidateRouteBusinessCount() const {
+    return strategy->getCandidateRouteBusinessCount();
+}
@@ -0,0 +1,133 @@
+/*
+ * Description: 路由库接口，不依赖标准输入输出，一个进程里可以跑多个引擎
+ */
+#ifndef ROUTING_API_H
+#define ROUTING_API_H
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <string>
+
+struct StrategyBase;
+struct TraceWriter;
+
+//网络输入，顶点、边、业务编号都从1开始，和比赛输入一致，数组下标0对应编号1
+struct NetworkEdge {
+    int from;
+    int to;
+};
+
+struct NetworkBusiness {
+    int from;
+    int to;
+    int startChannel;
+    int endChannel;
+    int value;
+    std::vector<int> edgeIds;//初始路径经过的边
+};
+
+struct NetworkInput {
+    int channelCount = 40;//每条边的通道数，支持40、64、80、96
+    int vertexCount{};
+    std::vector<int> changeCounts;//每个顶点的变通道次数
+    std::vector<NetworkEdge> edges;
+    std::vector<NetworkBusiness> businesses;
+};
+
+//断边以后重新规划的业务，没出现的受影响业务就是死了
+struct RouteSegment {
+    int edgeId;
+    int startChannel;
+    int endChannel;
+};
+
+struct ReroutedBusiness {
+    int businessId;
+    std::vector<RouteSegment> segments;
+};
+
+typedef std::vector<ReroutedBusiness> ReroutePlan;
+
+//自己调整的变通道能力和生成的断边序列
+struct SampleSet {
+    std::vector<int> changeCounts;
+    std::vector<std::vector<int>> samples;
+    std::vector<int> maxLengths;//每个样例调度时按多长估计资源，重放用
+};
+
+//一次断边调度里和时间有关的决定，离线重放时照着做就能得到一样的输出
+struct DispatchDecision {
+    int passes = 1;//排了几遍，包括第一遍
+    int heuristicWeight = 100;//启发乘的百分比
+    bool candidateRouteOnly = false;//是否只用候选路径
+    bool lastPassInterrupted = false;//最后一遍被截止时间打断
+    int configIndex = 0;//组合调度赢的参数组，0是主参数
+    bool speculated = false;//结果是推测的克隆算的，克隆的路径缓存不一样，重放可能对不上
+};
+
+//引擎参数，默认和比赛一样
+struct EngineOptions {
+    int timeLimit = 0;//整个流程的时间限制(ms)，所有时间参数按比例缩放，0表示按比赛时间
+    int threadCount = 0;//0用进程共用的线程池，大于0引擎自己建这么多线程的池，多个引擎并行时设1
+    std::string tracePath;//非空时把网络、样例、每条断边的决定和输出记到这个二进制文件里，记录时不用路径缓存
+    bool replay = false;//重放模式，不分配变通道能力也不生成样例，断边按记录的决定调度，不做推测
+    int candidateRouteBusinessCount = -1;//重放和检查用，init建候选路径时建到第几个业务，-1表示按时间
+    bool capabilitySearch = true;//变通道能力局部搜索，有时间限制，检查初始化结果和线程数无关时关掉
+    bool incrementalSearch = true;//多次重排时保留搜索树，重放时关掉可以对比用时
+};
+
+//路由引擎，按比赛流程调用：loadNetwork -> generateSamples -> beginScenarios，
+//每个场景beginScenario -> 多次failEdge -> endScenario，等待断边期间可以startIdleWork后台推测
+struct RoutingEngine {
+    explicit RoutingEngine(const EngineOptions &options = EngineOptions());
+
+    ~RoutingEngine();
+
+    RoutingEngine(const RoutingEngine &) = delete;
+
+    RoutingEngine &operator=(const RoutingEngine &) = delete;
+
+    //通道数不支持或者顶点数、边数太大返回false
+    bool loadNetwork(const NetworkInput &input);
+
+    SampleSet generateSamples();
+
+    //重放用，代替generateSamples，直接用记录的变通道能力和样例
+    void loadSamples(const SampleSet &sampleSet);
+
+    void beginScenarios(int count);
+
+    void beginScenario();
+
+    void startIdleWork();
+
+    void stopIdleWork();
+
+    ReroutePlan failEdge(int edgeId);
+
+    //重放用，按记录的决定调度
+    ReroutePlan replayFailEdge(int edgeId, const DispatchDecision &decision);
+
+    //搜索随机数的状态，重放时在每个场景开始对一下
+    unsigned long long getSearchRandomState() const;
+
+    void setSearchRandomState(unsigned long long state);
+
+    //初始化结果的哈希，检查并行归约的顺序不受线程数影响
+    unsigned long long getInitHash() const;
+
+    //init建了候选路径的业务数，和时间有关
+    int getCandidateRouteBusinessCount() const;
+
+    //返回这个场景的得分，存活价值占比乘10000
+    double endScenario();
+
+private:
+    EngineOptions options;
+    std::chrono::steady_clock::time_point createTime;//按比赛计时，引擎创建时就开始
+    std::unique_ptr<StrategyBase> strategy;
+    std::unique_ptr<TraceWriter> trace;
+};
+
+#endif //ROUTING_API_H
@@ -0,0 +1,5150 @@
+/*
+ * Description: 十分简单的一种解法，主要思路是随机生成穷举最大分差，然后按照剩余资源寻找最短路径
+ * Date: 2024-05-18
+ */
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include "routing_api.h"
+#include <iostream>
+#include <string>
+#include <random>
+#include <chrono>
+#include <unordered_set>
+#include <unordered_map>
+#include <queue>
+#include <cassert>
+#include <algorithm>
+#include <map>
+#include <cstring>
+#include <cmath>
+#include <bitset>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HAS_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+//创建参数
+const int CREATE_SAMPLE_RANDOM_SEED = 666;//创建样例种子
+const int CREATE_BASE_SAMPLE_CANDIDATE_COUNT = 8;//基础序列生成，候选序列个数
+const int CREATE_OPTIMIZE_SAMPLE_CANDIDATE_COUNT = 3;//优化基础序列，候选序列个数
+const int CREATE_BASE_EDGE_CANDIDATE_COUNT = 12;//基础序列生成，候选边的条数
+const int CREATE_OPTIMIZE_EDGE_CANDIDATE_COUNT = 20;//优化基础序列，候选边的条数
+const int CREATE_SHUFFLE_MAX_TRY_COUNT = 5;//不满足相似度约束时，最多尝试几次？
+const int CREATE_BASE_SAMPLES_MAX_TIME = 40 * 1000;//基础序列生成，最大运行时间
+const int CREATE_OPTIMIZE_SAMPLES_MAX_TIME = CREATE_BASE_SAMPLES_MAX_TIME + 45 * 1000;//优化基础序列，最大运行时间
+
+const double MY_SAMPLE_SEARCH_RESOURCE_FACTOR = 1.0;//创建我自己样例的寻路因子
+const double OTHER_SAMPLE_SEARCH_RESOURCE_FACTOR = 1.0;//优化其他样例的寻路因子
+
+//进化优化参数
+const int GENETIC_TOURNAMENT_SIZE = 2;//锦标赛选父代，参赛个数
+const int GENETIC_MUTATION_COUNT = 3;//子代最多替换几条边
+const int GENETIC_IMMIGRANT_PERCENT = 25;//子代里直接用myGenerate新生成的比例，保持多样性
+const int GENETIC_MAX_STALE_GENERATIONS = 180;//连续这么多代没有替换就结束
+
+//代理模型参数
+static bool USE_SURROGATE = true;//候选序列先用代理模型预测分差，只有预测最好的去完整模拟
+const int SURROGATE_SCREEN_FACTOR = 5;//每个进入完整模拟的候选生成几个
+const int SURROGATE_MIN_TRAINING = 24;//模型见过这么多完整模拟结果以后才开始筛
+
+//变通道能力分配参数
+const int MAX_VERTEX_CHANGE_COUNT = 20;//每个顶点的变通道能力上限
+static bool USE_CAPABILITY_SEARCH = true;//热力图分配以后，用探测场景模拟，局部搜索在顶点之间挪变通道能力
+const int CAPABILITY_SEARCH_TIME = 3 * 1000;//局部搜索最多用多久
+const int CAPABILITY_PROBE_COUNT = 16;//探测场景个数
+const int CAPABILITY_PROBE_LENGTH = 30;//每个探测场景断几条边
+const int CAPABILITY_RANDOM_SEED = 666;//生成探测场景和挑顶点的种子
+
+//创建常量
+const int CREATE_SAMPLE_COUNT = 30;//创建样例最大个数
+const double CREATE_SAMPLE_SIMILARITY_THRESHOLD = 0.5;//相似度约束
+const int EVERY_SCENE_MAX_FAIL_EDGE_COUNT = 60;//一个场景场景最大断边数
+
+//迭代参数
+const int SEARCH_RANDOM_SEED = 666;//搜索种子
+static bool IS_ONLINE = true;//是否线上，可以充分利用时间迭代他给的样例
+const int EDGE_LENGTH_WEIGHT = 100;//边的权重，基本可以不改变
+
+//增量搜索参数
+static bool USE_INCREMENTAL_SEARCH = true;//线上多次重排时，每个业务保留搜索树，重排只修复变化的部分
+const int INCREMENTAL_SEARCH_MIN_BUSINESS = 8;//受影响业务少于这个数不值得建树
+const long long INCREMENTAL_SEARCH_MAX_BYTES = 64LL << 20;//一次调度所有搜索树最多占的内存，树建满了剩下的业务用aStar2
+
+//候选路径参数
+const int CANDIDATE_ROUTE_COUNT = 4;//每个(起点,终点)预先保存的最短无环路径条数
+const int CANDIDATE_ROUTE_MAX_TIME = 2000;//init建候选路径最多用的时间
+const double CANDIDATE_ROUTE_FAST_TIME_SLICE = 0.2;//每次断边平均剩余时间(ms)低于这个，候选路径能用就不搜索
+
+//有界次优搜索参数
+const int HEURISTIC_WEIGHT_EXACT = 100;//启发权重百分比，100是普通aStar
+static int FOCAL_HEURISTIC_WEIGHT = 130;//时间片太小时启发乘这个百分比，路径代价不超过最短的这么多倍，展开更少
+const double FOCAL_SEARCH_TIME_SLICE = 2.0;//每次断边平均剩余时间(ms)低于这个，改用加权启发
+
+//推测参数
+static bool USE_SPECULATION = true;//等待下一条断边时，后台提前调度最可能断的边
+const int SPECULATION_EDGE_COUNT = 3;//每次最多推测几条边
+
+//共用搜索树参数
+static bool USE_SHARED_SEARCH = true;//起点和宽度相同的受影响业务共用一棵搜索树
+const int SHARED_SEARCH_MIN_GROUP_SIZE = 2;//组里至少几个业务才共用
+
+//时间预算参数
+const double TIME_BUDGET_MAX_FACTOR = 6.0;//一次断边最多拿平均时间的几倍
+
+//预计算缓存参数
+const char *const PRECOMPUTE_CACHE_DIR_ENV = "PRECOMPUTE_CACHE_DIR";//设置了这个环境变量才读写缓存，值为缓存目录
+const unsigned PRECOMPUTE_CACHE_MAGIC = 0x50434543;//文件头
+const unsigned PRECOMPUTE_CACHE_VERSION = 3;//init里预计算的算法改了要加1
+
+//线程池参数
+static bool USE_TASK_POOL = true;//多核时初始化打分、生成样例、组合调度并行
+const int TASK_POOL_THREAD_COUNT = 0;//线程数，包括主线程，0表示按核数
+const int TASK_POOL_MAX_THREAD_COUNT = 4;//线程数上限
+
+//组合调度参数
+static bool USE_PORTFOLIO = true;//多核时每条断边用几组寻路参数并行调度，取分最高的
+
+//双向搜索参数
+static bool USE_BIDIRECTIONAL_SEARCH = true;//远距离业务两头同时搜，前沿比单向窄
+const int BIDIRECTIONAL_MIN_DISTANCE = 32;//起终点跳数不少于这个才用双向，近的单向更快
+
+//路径缓存参数
+static bool USE_PATH_CACHE = true;//是否复用依赖状态没变的寻路结果
+const int PATH_CACHE_MAX_SIZE = 1 << 15;//缓存条目上限，超过直接清空
+static bool CHECK_PATH_CACHE = false;//调试用，命中缓存时再搜一次，代价不一样记到统计里
+static bool PRINT_STATISTICS = false;//是否往stderr输出统计信息
+
+//搜索常量
+static int MAX_E_FAIL_COUNT = 4200;//他的的样例的最大断边数，最大断边数5k
+const int SEARCH_TIME = 90 * 1000;//程序整体运行时间
+const int SEARCH_SAFE_TIME = 1000;//离整体运行时间还剩这么多时，正在进行的搜索强制结束
+const int DEADLINE_CHECK_INTERVAL = 64;//搜索每弹出多少次检查一次截止时间，2的幂
+const int MAX_SPECIALIZED_WIDTH = 8;//aStar按宽度展开的内核个数，题目业务宽度不超过这个
+
+//其他常量
+const int MAX_SEARCH_ID = 1 << 16;//搜索状态把通道和顶点、边编号压在一个int里，顶点数和边数都要小于这个
+const int INT_INF = 0x7f7f7f7f;
+const int INCREMENTAL_INF = INT_INF / 4;//增量搜索的无穷大，加上代价不溢出
+
+static atomic<long long> stateGenerationId(0);//全局递增的状态版本号，不同对象、不同线程之间也不会重复
+
+inline long long nextGeneration() {
+    return stateGenerationId.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+//每个引擎自己的时钟，创建时开始计时。批量跑时按时间限制缩放，整个时间线按比例压缩，
+//所有时间参数都还是按SEARCH_TIME写
+struct Clock {
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    double scale = 1.0;//SEARCH_TIME/实际时间限制
+
+    inline int now() const {
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - startTime);
+        return int(double(duration.count()) * scale / 1000);
+    }
+};
+
+//搜索截止令牌，搜索里每弹出一定次数检查一次，过期以后所有搜索直接失败
+struct Deadline {
+    int endTime = INT_INF;//runtime超过这个就过期
+    const Clock *clock = nullptr;//设endTime的时候一起设
+    const atomic<bool> *cancelFlag = nullptr;//推测的克隆用，主线程收到输入后取消
+    bool expired = false;
+
+    inline bool check() {
+        if (!expired && ((cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed))
+                         || (endTime != INT_INF && clock->now() > endTime))) {
+            expired = true;
+        }
+        return expired;
+    }
+};
+
+//工作窃取线程池，所有并行阶段共用。每个线程一个双端队列，自己从尾部取，空了从别人头部偷，
+//调用线程是0号，一起干活。任务开始前过了截止时间就跳过，结果由调用方按下标顺序归约，不能嵌套调用，
+//多个引擎同时调用时排队
+struct TaskPool {
+    struct WorkerQueue {
+        mutex lock;
+        deque<int> tasks;
+    };
+
+    struct Statistics {
+        atomic<long long> batches{0};//并行批次数
+        atomic<long long> tasks{0};//执行的任务数
+        atomic<long long> steals{0};//偷来的任务数
+        atomic<long long> skipped{0};//过了截止时间跳过的任务数
+    };
+
+    vector<thread> threads;
+    vector<unique_ptr<WorkerQueue>> queues;
+    mutex runLock;
+    mutex batchLock;
+    condition_variable batchStart, batchDone;
+    const function<void(int, int)> *batchTask = nullptr;
+    vector<char> batchFinished;
+    const Clock *batchClock = nullptr;
+    int batchEndTime = INT_INF;
+    long long batchId = 0;
+    int activeWorkers = 0;
+    bool stopping = false;
+    Statistics statistics;
+
+    explicit TaskPool(int workerCount) {
+        for (int i = 0; i < workerCount; i++) {
+            queues.emplace_back(new WorkerQueue());
+        }
+        for (int i = 1; i < workerCount; i++) {
+            threads.emplace_back([this, i]() { workerLoop(i); });
+        }
+    }
+
+    ~TaskPool() {
+        {
+            lock_guard<mutex> guard(batchLock);
+            stopping = true;
+        }
+        batchStart.notify_all();
+        for (thread &worker: threads) {
+            worker.join();
+        }
+    }
+
+    int size() const {
+        return int(queues.size());
+    }
+
+    //执行task(worker, index)，index从0到taskCount-1，返回每个任务是否执行了，endTime按clock算
+    vector<char> run(int taskCount, const function<void(int, int)> &task, const Clock *clock = nullptr,
+                     int endTime = INT_INF) {
+        lock_guard<mutex> runGuard(runLock);
+        batchFinished.assign(taskCount, 0);
+        if (taskCount == 0) {
+            return batchFinished;
+        }
+        statistics.batches++;
+        for (int i = 0; i < taskCount; i++) {
+            WorkerQueue &queue = *queues[i % size()];
+            lock_guard<mutex> guard(queue.lock);
+            queue.tasks.push_back(i);
+        }
+        {
+            lock_guard<mutex> guard(batchLock);
+            batchTask = &task;
+            batchClock = clock;
+            batchEndTime = clock != nullptr ? endTime : INT_INF;
+            activeWorkers = size() - 1;
+            batchId++;
+        }
+        batchStart.notify_all();
+        drain(0);
+        {
+            unique_lock<mutex> guard(batchLock);
+            batchDone.wait(guard, [this]() { return activeWorkers == 0; });
+            batchTask = nullptr;
+        }
+        return batchFinished;
+    }
+
+    //任务全部在批次开始前放好，所有队列都空了就说明这批分完了
+    void drain(int worker) {
+        while (true) {
+            int index = -1;
+            {
+                WorkerQueue &queue = *queues[worker];
+                lock_guard<mutex> guard(queue.lock);
+                if (!queue.tasks.empty()) {
+                    index = queue.tasks.back();
+                    queue.tasks.pop_back();
+                }
+            }
+            for (int k = 1; index == -1 && k < size(); k++) {
+                WorkerQueue &queue = *queues[(worker + k) % size()];
+                lock_guard<mutex> guard(queue.lock);
+                if (!queue.tasks.empty()) {
+                    index = queue.tasks.front();
+                    queue.tasks.pop_front();
+                    statistics.steals++;
+                }
+            }
+            if (index == -1) {
+                return;
+            }
+            if (batchEndTime != INT_INF && batchClock->now() > batchEndTime) {
+                statistics.skipped++;
+                continue;
+            }
+            (*batchTask)(worker, index);
+            batchFinished[index] = 1;
+            statistics.tasks++;
+        }
+    }
+
+    void workerLoop(int worker) {
+        long long seenBatchId = 0;
+        while (true) {
+            {
+                unique_lock<mutex> guard(batchLock);
+                batchStart.wait(guard, [&]() { return stopping || batchId != seenBatchId; });
+                if (stopping) {
+                    return;
+                }
+                seenBatchId = batchId;
+            }
+            drain(worker);
+            {
+                lock_guard<mutex> guard(batchLock);
+                if (--activeWorkers == 0) {
+                    batchDone.notify_all();
+                }
+            }
+        }
+    }
+};
+
+//序列分差的代理模型，在线岭回归，每来一个完整模拟的结果重解一次正规方程，特征很少，解一次很便宜
+struct SurrogateModel {
+    static const int FEATURE_COUNT = 7;
+    double xtx[FEATURE_COUNT][FEATURE_COUNT]{};
+    double xty[FEATURE_COUNT]{};
+    double weights[FEATURE_COUNT]{};
+    int sampleCount = 0;
+    //统计，筛的时候的预测和之后完整模拟的分差，算相关系数
+    long long generated = 0;
+    long long promoted = 0;
+    long long pairs = 0;
+    double sumP = 0, sumA = 0, sumPP = 0, sumAA = 0, sumPA = 0;
+
+    double predict(const double *x) const {
+        double y = 0;
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            y += weights[i] * x[i];
+        }
+        return y;
+    }
+
+    void add(const double *x, double y) {
+        if (sampleCount >= SURROGATE_MIN_TRAINING) {
+            double p = predict(x);
+            pairs++;
+            sumP += p;
+            sumA += y;
+            sumPP += p * p;
+            sumAA += y * y;
+            sumPA += p * y;
+        }
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            for (int j = 0; j < FEATURE_COUNT; j++) {
+                xtx[i][j] += x[i] * x[j];
+            }
+            xty[i] += x[i] * y;
+        }
+        sampleCount++;
+        solve();
+    }
+
+    double correlation() const {
+        if (pairs < 2) {
+            return 0;
+        }
+        double cov = sumPA - sumP * sumA / pairs;
+        double varP = sumPP - sumP * sumP / pairs;
+        double varA = sumAA - sumA * sumA / pairs;
+        return varP <= 0 || varA <= 0 ? 0 : cov / sqrt(varP * varA);
+    }
+
+    //正则项按对角线的比例加，特征量纲差很多也不用归一化
+    void solve() {
+        double a[FEATURE_COUNT][FEATURE_COUNT + 1];
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            for (int j = 0; j < FEATURE_COUNT; j++) {
+                a[i][j] = xtx[i][j];
+            }
+            a[i][i] += 1e-3 * xtx[i][i] + 1e-9;
+            a[i][FEATURE_COUNT] = xty[i];
+        }
+        for (int col = 0; col < FEATURE_COUNT; col++) {
+            int pivot = col;
+            for (int i = col + 1; i < FEATURE_COUNT; i++) {
+                if (fabs(a[i][col]) > fabs(a[pivot][col])) {
+                    pivot = i;
+                }
+            }
+            if (fabs(a[pivot][col]) < 1e-12) {
+                return;
+            }
+            for (int j = 0; j <= FEATURE_COUNT; j++) {
+                swap(a[col][j], a[pivot][j]);
+            }
+            for (int i = 0; i < FEATURE_COUNT; i++) {
+                if (i == col) {
+                    continue;
+                }
+                double factor = a[i][col] / a[col][col];
+                for (int j = col; j <= FEATURE_COUNT; j++) {
+                    a[i][j] -= factor * a[col][j];
+                }
+            }
+        }
+        for (int i = 0; i < FEATURE_COUNT; i++) {
+            weights[i] = a[i][FEATURE_COUNT] / a[i][i];
+        }
+    }
+};
+
+//只读打开整个文件，能mmap就mmap，否则读到内存里
+struct MappedFile {
+    const char *data = nullptr;
+    size_t size = 0;
+    vector<char> buffer;
+#ifdef HAS_MMAP
+    void *mapped = nullptr;
+#endif
+
+    bool open(const string &path) {
+#ifdef HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st{};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *address = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                mapped = address;
+                data = (const char *) address;
+                size = size_t(st.st_size);
+                ::close(fd);
+                return true;
+            }
+        }
+        ::close(fd);
+#endif
+        FILE *file = fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        char chunk[1 << 16];
+        size_t count;
+        while ((count = fread(chunk, 1, sizeof chunk, file)) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + count);
+        }
+        fclose(file);
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+    }
+
+    ~MappedFile() {
+#ifdef HAS_MMAP
+        if (mapped != nullptr) {
+            munmap(mapped, size);
+        }
+#endif
+    }
+};
+
+//按顺序读int，越界以后一直失败
+struct BinaryReader {
+    const char *data;
+    size_t size;
+    size_t offset = 0;
+    bool failed = false;
+
+    BinaryReader(const char *data, size_t size) : data(data), size(size) {}
+
+    template<typename T>
+    T read() {
+        T value{};
+        if (failed || offset + sizeof(T) > size) {
+            failed = true;
+            return value;
+        }
+        memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+};
+
+inline void fnvHash(unsigned long long &hash, long long value) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (unsigned long long) (value >> (i * 8)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+}
+
+//进程唯一的线程池，线程数按核数
+inline TaskPool &getTaskPool() {
+    static TaskPool pool(!USE_TASK_POOL ? 1 : max(1, min(TASK_POOL_THREAD_COUNT > 0 ? TASK_POOL_THREAD_COUNT
+                                                                                      : int(thread::hardware_concurrency()),
+                                                          TASK_POOL_MAX_THREAD_COUNT)));
+    return pool;
+}
+
+//通道掩码，第c位表示起始通道c，通道数超过63时用多个字
+template<int WORDS>
+struct ChannelMask {
+    unsigned long long words[WORDS]{};
+
+    static ChannelMask full() {
+        ChannelMask mask;
+        for (int i = 0; i < WORDS; i++) {
+            mask.words[i] = ~0ULL;
+        }
+        return mask;
+    }
+
+    inline bool test(int bit) const {
+        return (words[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    inline void set(int bit) {
+        words[bit >> 6] |= 1ULL << (bit & 63);
+    }
+
+    inline bool any() const {
+        for (int i = 0; i < WORDS; i++) {
+            if (words[i] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //最低的置位，调用前保证非空
+    inline int lowest() const {
+        int i = 0;
+        while (words[i] == 0) {
+            i++;
+        }
+        return (i << 6) + __builtin_ctzll(words[i]);
+    }
+
+    inline void clearLowest() {
+        int i = 0;
+        while (words[i] == 0) {
+            i++;
+        }
+        words[i] &= words[i] - 1;
+    }
+
+    inline ChannelMask operator&(const ChannelMask &o) const {
+        ChannelMask mask;
+        for (int i = 0; i < WORDS; i++) {
+            mask.words[i] = words[i] & o.words[i];
+        }
+        return mask;
+    }
+
+    inline ChannelMask &operator&=(const ChannelMask &o) {
+        for (int i = 0; i < WORDS; i++) {
+            words[i] &= o.words[i];
+        }
+        return *this;
+    }
+
+    inline ChannelMask operator~() const {
+        ChannelMask mask;
+        for (int i = 0; i < WORDS; i++) {
+            mask.words[i] = ~words[i];
+        }
+        return mask;
+    }
+
+    inline bool operator==(const ChannelMask &o) const {
+        for (int i = 0; i < WORDS; i++) {
+            if (words[i] != o.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline bool operator!=(const ChannelMask &o) const {
+        return !(*this == o);
+    }
+};
+
+const unsigned short UNREACHABLE_DISTANCE = 0xFFFF;//不连通的跳数
+
+//按行存的跳数方阵，行数运行时定；顶点编号只有16位，跳数一定放得下
+struct DistanceMatrix {
+    int size = 0;
+    vector<unsigned short> data;
+
+    void resize(int rowCount) {
+        size = rowCount;
+        data.assign(size_t(rowCount) * rowCount, 0);
+    }
+
+    inline unsigned short *operator[](int row) {
+        return data.data() + size_t(row) * size;
+    }
+
+    inline const unsigned short *operator[](int row) const {
+        return data.data() + size_t(row) * size;
+    }
+};
+
+//每个(顶点,通道)状态一个经过顶点的集合，防止路径成环，集合长度按顶点数，补齐到4个字一块好展开复制
+struct VertexSets {
+    static const int BLOCK_WORDS = 4;
+    int words = 0;
+    vector<unsigned long long> data;
+
+    //只会变大，状态在本次搜索写过以后才会读，不用清空
+    void prepare(int stateCount, int vertexCount) {
+        int blocks = (vertexCount + 64 * BLOCK_WORDS - 1) / (64 * BLOCK_WORDS);
+        words = blocks * BLOCK_WORDS;
+        if (data.size() < size_t(stateCount) * words) {
+            data.resize(size_t(stateCount) * words);
+        }
+    }
+
+    inline unsigned long long *row(int state) {
+        return data.data() + size_t(state) * words;
+    }
+
+    static inline bool test(const unsigned long long *set, int vertex) {
+        return (set[vertex >> 6] >> (vertex & 63)) & 1;
+    }
+
+    inline void reset(int state) {
+        memset(row(state), 0, sizeof(unsigned long long) * words);
+    }
+
+    //target为source加上vertex
+    static inline void extend(unsigned long long *target, const unsigned long long *source, int words, int vertex) {
+        for (int i = 0; i < words; i += BLOCK_WORDS) {
+            for (int j = 0; j < BLOCK_WORDS; j++) {
+                target[i + j] = source[i + j];
+            }
+        }
+        target[vertex >> 6] |= 1ULL << (vertex & 63);
+    }
+};
+
+//路径上的一段
+struct Point {
+    int edgeId;
+    int startChannelId;
+    int endChannelId;
+};
+
+//边，通道数是模板参数，不同通道数的内核分别实例化
+template<int CHANNEL_COUNT>
+struct Edge {
+    typedef ChannelMask<CHANNEL_COUNT / 64 + 1> Mask;
+    int from{};
+    int to{};
+    bool die{};
+    long long generation{};//通道表或者死亡状态变化时更新，路径缓存用来判断失效
+    int channel[CHANNEL_COUNT + 1]{};//0号不用
+    int freeChannelTable[CHANNEL_COUNT + 1][CHANNEL_COUNT + 1]{};//打表加快搜索速度
+    bitset<(CHANNEL_COUNT + 1) * (CHANNEL_COUNT + 1)> widthChannelTable;//指示某个宽度某条通道是否被占用
+    Mask freeChannelMask[CHANNEL_COUNT + 1]{};//某个宽度能用的起始通道掩码，版本号变了用它再判断一次
+    //经过这条边的存活业务，按占的第一个通道排序，和扫通道表的顺序一样；调度时老路径新路径可能同时占着
+    struct LiveBusiness {
+        int id;
+        int channels;//占的通道数
+        int firstChannel;
+    };
+    int liveCount{};
+    int liveValue{};//存活业务价值和
+    LiveBusiness lives[CHANNEL_COUNT]{};
+
+    Edge() {
+        memset(channel, -1, sizeof(channel));
+    }
+
+    void reset() {
+        memset(channel, -1, sizeof(channel));
+        die = false;//没有断掉
+        liveCount = 0;
+        liveValue = 0;
+    }
+
+    inline bool sameLives(const Edge &o) const {
+        return liveCount == o.liveCount && liveValue == o.liveValue
+               && memcmp(lives, o.lives, sizeof(LiveBusiness) * liveCount) == 0;
+    }
+
+    inline int findLive(int id) const {
+        for (int k = 0; k < liveCount; k++) {
+            if (lives[k].id == id) {
+                return k;
+            }
+        }
+        return -1;
+    }
+
+    //第一个通道变了以后挪回有序的位置
+    inline void placeLive(int k) {
+        while (k > 0 && lives[k - 1].firstChannel > lives[k].firstChannel) {
+            swap(lives[k - 1], lives[k]);
+            k--;
+        }
+        while (k + 1 < liveCount && lives[k + 1].firstChannel < lives[k].firstChannel) {
+            swap(lives[k + 1], lives[k]);
+            k++;
+        }
+    }
+
+    //业务新占了从firstChannel开始的count个通道
+    inline void addLive(int id, int value, int firstChannel, int count) {
+        int k = findLive(id);
+        if (k == -1) {
+            k = liveCount++;
+            lives[k] = {id, count, firstChannel};
+            liveValue += value;
+        } else {
+            lives[k].channels += count;
+            lives[k].firstChannel = min(lives[k].firstChannel, firstChannel);
+        }
+        placeLive(k);
+    }
+
+    inline void eraseLive(int k, int value) {
+        liveValue -= value;
+        liveCount--;
+        for (; k < liveCount; k++) {
+            lives[k] = lives[k + 1];
+        }
+    }
+
+    //业务放掉了count个通道，通道表已经改过
+    inline void removeLive(int id, int value, int count) {
+        int k = findLive(id);
+        if (k == -1) {
+            return;
+        }
+        lives[k].channels -= count;
+        if (lives[k].channels == 0) {
+            eraseLive(k, value);
+            return;
+        }
+        for (int j = 1; j <= CHANNEL_COUNT; j++) {
+            if (channel[j] == id) {
+                lives[k].firstChannel = j;
+                break;
+            }
+        }
+        placeLive(k);
+    }
+
+    //业务死了，通道还占着
+    inline void killLive(int id, int value) {
+        int k = findLive(id);
+        if (k != -1) {
+            eraseLive(k, value);
+        }
+    }
+};
+
+//邻接表的边
+struct NearEdge {
+    int id;
+    int to;
+};
+
+//CSR邻接表，每个顶点的出边连续存两遍，任意起点转一圈都是连续的一段
+//断边不从表里删，搜索看边上的die；重排只改每个顶点的起点，reset只清起点
+struct AdjacencyGraph {
+    vector<int> offsets;//顶点v的两遍出边在[offsets[v], offsets[v + 1])
+    vector<NearEdge> nearEdges;
+    vector<int> rotations;//遍历起点
+
+    struct Range {
+        const NearEdge *first;
+        const NearEdge *last;
+
+        inline const NearEdge *begin() const {
+            return first;
+        }
+
+        inline const NearEdge *end() const {
+            return last;
+        }
+    };
+
+    void build(const vector<vector<NearEdge>> &lists) {
+        int vertexCount = int(lists.size());
+        offsets.assign(vertexCount + 1, 0);
+        nearEdges.clear();
+        for (int v = 0; v < vertexCount; v++) {
+            offsets[v] = int(nearEdges.size());
+            nearEdges.insert(nearEdges.end(), lists[v].begin(), lists[v].end());
+            nearEdges.insert(nearEdges.end(), lists[v].begin(), lists[v].end());
+        }
+        offsets[vertexCount] = int(nearEdges.size());
+        reset();
+    }
+
+    //顶点编号上限加1
+    inline int size() const {
+        return int(offsets.size()) - 1;
+    }
+
+    inline int degree(int v) const {
+        return (offsets[v + 1] - offsets[v]) >> 1;
+    }
+
+    inline Range operator[](int v) const {
+        const NearEdge *first = nearEdges.data() + offsets[v] + rotations[v];
+        return {first, first + degree(v)};
+    }
+
+    //按原始顺序
+    void reset() {
+        rotations.assign(size(), 0);
+    }
+
+    //每个顶点随机一个起点，代替打乱出边
+    template<class Random>
+    void shuffle(Random &rad) {
+        for (int v = 0; v < size(); v++) {
+            int d = degree(v);
+            rotations[v] = d <= 1 ? 0 : int(rad() % d);
+        }
+    }
+};
+
+//业务
+struct Business {
+    int id{};
+    int from{};
+    int to{};
+    int needChannelLength{};
+    int value{};
+    bool die{};
+
+    void reset() {
+        die = false;
+    }
+
+};
+
+//顶点，分配完变通道能力以后不变，会变的部分在VertexStates
+struct Vertex {
+    int maxChangeCount{};
+    int hotWeight{};
+};
+
+//顶点会变的状态按字段分开存成平坦数组，搜索热路径只读这两个，克隆整块拷贝
+struct VertexStates {
+    vector<int> changeCounts;//剩余变通道次数
+    vector<char> dies;//假设死亡不会变业务,有变通道次数且不die
+
+    inline int size() const {
+        return int(changeCounts.size());
+    }
+
+    inline bool canChange(int v) const {
+        return changeCounts[v] > 0 && !dies[v];
+    }
+
+    void reset(const vector<Vertex> &vertices) {
+        changeCounts.resize(vertices.size());
+        dies.assign(vertices.size(), 0);
+        for (int i = 0; i < vertices.size(); i++) {
+            changeCounts[i] = vertices[i].maxChangeCount;
+        }
+    }
+};
+
+//引擎用的接口，按通道数实例化不同的Strategy
+struct StrategyBase {
+    virtual ~StrategyBase() = default;
+
+    virtual void setTimeLimit(std::chrono::steady_clock::time_point startTime, int timeLimit) = 0;
+
+    virtual void setThreadCount(int threadCount) = 0;
+
+    virtual void init(const NetworkInput &input) = 0;
+
+    virtual vector<int> getChangeCounts() const = 0;
+
+    virtual vector<vector<int>> createSamples() = 0;
+
+    virtual void beginScenarios(int count) = 0;
+
+    virtual void beginScenario() = 0;
+
+    virtual void startIdleWork() = 0;
+
+    virtual void stopIdleWork() = 0;
+
+    virtual const unordered_map<int, vector<Point>> &failEdge(int failEdgeId) = 0;
+
+    virtual double endScenario() = 0;
+
+    //记录和重放
+    virtual void setReplay() = 0;
+
+    virtual void setCandidateRouteBusinessCount(int count) = 0;
+
+    virtual int getCandidateRouteBusinessCount() const = 0;
+
+    virtual void setCapabilitySearch(bool enabled) = 0;
+
+    virtual void setIncrementalSearch(bool enabled) = 0;
+
+    virtual void setPathCache(bool enabled) = 0;
+
+    virtual unsigned long long getInitHash() const = 0;
+
+    virtual vector<int> getSampleMaxLengths() const = 0;
+
+    virtual void loadSamples(const SampleSet &sampleSet) = 0;
+
+    virtual const DispatchDecision &getLastDecision() const = 0;
+
+    virtual const unordered_map<int, vector<Point>> &replayFailEdge(int failEdgeId,
+                                                                    const DispatchDecision &decision) = 0;
+
+    virtual unsigned long long getSearchRandomState() const = 0;
+
+    virtual void setSearchRandomState(unsigned long long state) = 0;
+};
+
+//策略类
+template<int CHANNEL_COUNT>
+struct Strategy final : StrategyBase {
+    typedef ::Edge<CHANNEL_COUNT> Edge;
+    typedef typename Edge::Mask Mask;
+    //克隆同步和交换都是整块拷贝，调度会改的状态里不能有要深拷贝的成员
+    static_assert(is_trivially_copyable<Edge>::value, "Edge must be trivially copyable");
+    static_assert(is_trivially_copyable<Vertex>::value, "Vertex must be trivially copyable");
+    static_assert(is_trivially_copyable<Business>::value, "Business must be trivially copyable");
+    int N{};//节点数
+    int M{};//边数
+    default_random_engine createSampleRad{CREATE_SAMPLE_RANDOM_SEED};
+    default_random_engine searchRad{SEARCH_RANDOM_SEED};
+    vector<Edge> edges;
+    vector<Vertex> vertices;
+    VertexStates vertexStates;//调度会改的顶点状态
+    vector<vector<NearEdge>> graph;//邻接表
+    AdjacencyGraph searchGraph;//搜索用的邻接表，重排只改遍历起点
+    AdjacencyGraph baseSearchGraph;//baseline的邻接表，不变
+    vector<Business> buses;//业务
+    vector<vector<Point>> busesOriginResult;//业务最开始路径
+    DistanceMatrix minDistance;//用于aStar启发
+    int searchTime = 0; //统计寻路时间
+    int curHandleCount = 0;//目前处理的他给的断边总体个数
+    double resultScore[2]{}; //分数，0最大分数，1当前分数
+    int totalResource = 0;//总体资源
+    int remainResource = 0;//当前剩余资源
+    int totalEdgeValue = 0;//边上的总体价值，可以叠加
+    double remainEdgeValue = 0;//剩余的边上的价值
+    double remainEdgeSize = 0;//剩余存活的边数
+    double curAffectEdgeValue = 0;//当前断边影响的边上的价值
+    double avgEdgeAffectValue = 0;//平均断一条边影响的价值，最开始计算一边
+    vector<int> createScores;//生成基础打分
+    unordered_map<int, vector<Point>> lastDispatchResult;//最近一次dispatch选出的结果
+    vector<vector<vector<int>>> baseRepValue;//base寻到的路径，应该增加的分让他后面断掉
+    vector<vector<vector<int>>> meRepValue;//我寻到的路径，应该减少分，让他存活
+    vector<vector<vector<int>>> baseOriginValue;//base寻不到的路径，应该减少分，因为死亡了不重复断
+    Clock clock;//克隆复制一份，和主对象同一个起点
+    TaskPool *taskPool = nullptr;//空表示用进程共用的线程池
+    shared_ptr<TaskPool> ownTaskPool;//引擎自己的线程池，批量跑时每个引擎单线程
+
+    inline int runtime() const {
+        return clock.now();
+    }
+
+    inline TaskPool &getPool() const {
+        return taskPool != nullptr ? *taskPool : getTaskPool();
+    }
+
+    //threadCount为0用进程共用的线程池
+    void setThreadCount(int threadCount) override {
+        ownTaskPool = threadCount > 0 ? make_shared<TaskPool>(threadCount) : nullptr;
+        taskPool = ownTaskPool.get();
+    }
+
+    //整个流程压缩到timeLimit毫秒，从startTime开始计时，0表示按SEARCH_TIME
+    void setTimeLimit(std::chrono::steady_clock::time_point startTime, int timeLimit) override {
+        clock.startTime = startTime;
+        clock.scale = timeLimit > 0 ? 1.0 * SEARCH_TIME / timeLimit : 1.0;
+    }
+
+    struct SearchUtils {
+
+        //所有起点的跳数，64个起点一批，每个顶点一个字，第k位是这一批第k个起点，一层一起往外推一步；
+        //每批一个任务在线程池上跑，各写各的行。断掉的边不走，断边以后要重算也能用
+        //图是无向的，起点那一行就是各个顶点到它的跳数，按终点取行连续访问
+        static void hopDistances(const AdjacencyGraph &graph, const vector<Edge> &edges, DistanceMatrix &distance,
+                                 TaskPool &pool) {
+            const int vertexCount = graph.size();
+            const int batchCount = (vertexCount - 1 + 63) / 64;
+            pool.run(batchCount, [&](int, int batch) {
+                thread_local vector<unsigned long long> visitedStore, frontierStore, nextStore;
+                visitedStore.assign(vertexCount, 0);
+                frontierStore.assign(vertexCount, 0);
+                nextStore.resize(vertexCount);
+                unsigned long long *visited = visitedStore.data();
+                unsigned long long *frontier = frontierStore.data();
+                unsigned long long *next = nextStore.data();
+                const int first = 1 + batch * 64;
+                const int count = min(64, vertexCount - first);
+                for (int k = 0; k < count; k++) {
+                    unsigned short *row = distance[first + k];
+                    fill(row, row + vertexCount, UNREACHABLE_DISTANCE);
+                    row[first + k] = 0;
+                    visited[first + k] = frontier[first + k] = 1ULL << k;
+                }
+                bool expanded = true;
+                for (int level = 1; expanded; level++) {
+                    expanded = false;
+                    for (int v = 1; v < vertexCount; v++) {
+                        unsigned long long reach = 0;
+                        for (const NearEdge &nearEdge: graph[v]) {
+                            if (!edges[nearEdge.id].die) {
+                                reach |= frontier[nearEdge.to];
+                            }
+                        }
+                        reach &= ~visited[v];
+                        next[v] = reach;
+                        if (reach == 0) {
+                            continue;
+                        }
+                        expanded = true;
+                        visited[v] |= reach;
+                        while (reach != 0) {
+                            distance[first + __builtin_ctzll(reach)][v] = (unsigned short) level;
+                            reach &= reach - 1;
+                        }
+                    }
+                    swap(frontier, next);
+                }
+            });
+        }
+
+        //一次搜索读过的边和顶点，路径缓存用来判断结果是否还有效
+        struct SearchTrace {
+            vector<int> edgeIds;
+            vector<int> vertexIds;
+
+            void clear() {
+                edgeIds.clear();
+                vertexIds.clear();
+            }
+        };
+
+        //一个(顶点,通道)状态的字段放在一起，松弛时一次访问同一条缓存行
+        struct SearchState {
+            int timestamp;
+            int dist;
+            int parentStartChannelEdgeId;
+        };
+
+        typedef SearchState StateRow[CHANNEL_COUNT + 1];
+
+        //(顶点,通道)二维表，线程私有的存储按顶点数变大，用时间戳不用清空
+        static StateRow *stateTable(vector<SearchState> &store, int vertexCount) {
+            size_t size = size_t(vertexCount) * (CHANNEL_COUNT + 1);
+            if (store.size() < size) {
+                store.resize(size);
+            }
+            return reinterpret_cast<StateRow *>(store.data());
+        }
+
+        static int *growTable(vector<int> &store, size_t size) {
+            if (store.size() < size) {
+                store.resize(size);
+            }
+            return store.data();
+        }
+
+        //小根堆，距离相同时不保证顺序
+        struct FastQueue {
+            int size = 0;
+            int *dataDist = nullptr;//指向下面的存储，堆操作不经过vector
+            int *dataChannelVertex = nullptr;
+            vector<int> distStore;
+            vector<int> channelVertexStore;
+
+            //容量按顶点数定，只会变大
+            void reserve(int vertexCount) {
+                size_t capacity = size_t(CHANNEL_COUNT) * vertexCount * 10;
+                if (distStore.size() < capacity) {
+                    distStore.resize(capacity);
+                    channelVertexStore.resize(capacity);
+                    dataDist = distStore.data();
+                    dataChannelVertex = channelVertexStore.data();
+                }
+            }
+
+            void push(int dist, int channelVertex) {
+                //上推
+                int index = size + 1;
+                while (index != 1) {
+                    int last = index >> 1;
+                    //大通道在前面会更高分
+                    if (dataDist[last] >= dist) {
+                        //下推；
+                        dataDist[index] = dataDist[last];
+                        dataChannelVertex[index] = dataChannelVertex[last];
+                        index >>= 1;
+                    } else {
+                        break;
+                    }
+                }
+                dataDist[index] = dist;
+                dataChannelVertex[index] = channelVertex;
+                ++size;
+            }
+
+            int pop() {
+                //弹出第一个
+                int result = dataChannelVertex[1];
+                //最后一个放入第一个当中，下推
+                int curDist = dataDist[size];
+                int curChannelVertex = dataChannelVertex[size];
+                int index = 1;
+                while (true) {
+                    int next = index << 1;
+                    if (next >= size) break;
+                    int curMinDist = dataDist[next];
+                    int curMin = next;
+                    if (next + 1 < size && dataDist[next + 1] < curMinDist) {
+                        curMinDist = dataDist[next + 1];
+                        curMin = next + 1;
+                    }
+                    if (curMinDist < curDist) {
+                        dataDist[index] = dataDist[curMin];
+                        dataChannelVertex[index] = dataChannelVertex[curMin];
+                        index = curMin;
+                    } else {
+                        break;
+                    }
+                }
+                dataDist[index] = curDist;
+                dataChannelVertex[index] = curChannelVertex;
+                --size;
+                return result;
+            }
+
+            bool empty() const {
+                return size == 0;
+            }
+
+            int topDist() const {
+                return dataDist[1];
+            }
+
+            void clear() {
+                size = 0;
+            }
+        };
+
+        //baseLine寻路
+        inline static vector<Point>
+        baseFind(int start, int end, int width, const AdjacencyGraph &searchGraph,
+                 const vector<Edge> &edges) {
+            thread_local vector<SearchState> stateStore;
+            StateRow *states = stateTable(stateStore, int(searchGraph.size()));
+            thread_local int timestampId = 1;//距离
+            timestampId++;
+            int endChannel = -1;
+            queue<int> q;
+            for (int i = 1; i <= CHANNEL_COUNT; ++i) {
+                states[start][i].timestamp = timestampId;
+                q.emplace((i << 16) + start);
+            }
+            while (!q.empty()) {
+                const int poll = q.front();
+                q.pop();
+                const int lastChannel = poll >> 16;
+                const int lastVertex = poll & 0xFFFF;
+                if (lastVertex == end) {
+                    endChannel = lastChannel;
+                    break;
+                }
+                for (const NearEdge &nearEdge: searchGraph[lastVertex]) {
+                    const int next = nearEdge.to;
+                    const Edge &edge = edges[nearEdge.id];
+                    if (edge.die) {
+                        continue;
+                    }
+                    //没法变通道
+                    if (!edge.widthChannelTable[width * (CHANNEL_COUNT + 1) + lastChannel]) {
+                        continue;//不空闲直接结束
+                    }
+                    const int startChannel = lastChannel;
+                    if (states[next][startChannel].timestamp == timestampId) {
+                        //访问过了，且距离没变得更近
+                        continue;
+                    }
+                    states[next][startChannel].timestamp = timestampId;
+                    states[next][startChannel].parentStartChannelEdgeId = nearEdge.id;
+                    q.emplace((startChannel << 16) + next);
+                }
+            }
+            if (endChannel == -1) {
+                return {};
+            }
+            vector<Point> path;
+            int cur = end;
+            int curStartChannel = endChannel;
+            while (cur != start) {
+                int edgeId = states[cur][endChannel].parentStartChannelEdgeId;
+                path.push_back({edgeId, curStartChannel, curStartChannel + width - 1});
+                cur = edges[edgeId].from == cur ? edges[edgeId].to : edges[edgeId].from;
+            }
+            reverse(path.begin(), path.end());
+            return path;
+        }
+
+        //aStar的线程私有存储，各个宽度的内核共用一份
+        struct AStarScratch {
+            VertexSets parentVertexes;
+            vector<int> traceEdgeStore;
+            vector<int> traceVertexStore;
+            vector<SearchState> stateStore;
+            FastQueue q;
+            int timestampId = 1;
+            long long expansions = 0;//弹出次数，统计用
+        };
+
+        //0正向，1双向搜索的反向
+        static AStarScratch &aStarScratch(int direction = 0) {
+            thread_local AStarScratch scratch[2];
+            return scratch[direction];
+        }
+
+        //一次aStar搜索里不变的量，松弛函数用
+        struct AStarSearch {
+            StateRow *states;
+            VertexSets *parentVertexes;
+            FastQueue *q;
+            const vector<Edge> *edges;
+            const unsigned short *endDistance;
+            SearchTrace *trace;
+            int *traceEdgeTimestamp;
+            int timestampId;
+            int setWords;
+            int width;
+            int maxResource;
+            int changeChannelWeight;
+            int heuristicStep;//启发每跳的代价，加权时比走一条边大
+        };
+
+        //松弛一个顶点的所有出边，能不能变通道在弹出时判断一次，不在每条边上分支
+        template<int WIDTH, bool CAN_CHANGE>
+        static void relaxEdges(const AStarSearch &search, const AdjacencyGraph::Range nearEdges, const int lastVertex,
+                               const int lastChannel, const int lastDeep, const unsigned long long *lastSet) {
+            StateRow *const states = search.states;
+            FastQueue &q = *search.q;
+            const vector<Edge> &edges = *search.edges;
+            const unsigned short *const endDistance = search.endDistance;
+            const int timestampId = search.timestampId;
+            const int width = WIDTH > 0 ? WIDTH : search.width;
+            const int stepCost = width * EDGE_LENGTH_WEIGHT;
+            const int maxResource = search.maxResource;
+            const int changeChannelWeight = search.changeChannelWeight;
+            const int heuristicStep = search.heuristicStep;
+            const int setWords = search.setWords;
+            VertexSets &parentVertexes = *search.parentVertexes;
+            SearchTrace *const trace = search.trace;
+            int *const traceEdgeTimestamp = search.traceEdgeTimestamp;
+            const int nextBase = lastDeep + stepCost;//不变通道走一条边后的距离
+            for (const NearEdge &nearEdge: nearEdges) {
+                const int next = nearEdge.to;
+                //断边还在邻接表里，也要记进轨迹，断边恢复时缓存才会失效
+                if (trace != nullptr && traceEdgeTimestamp[nearEdge.id] != timestampId) {
+                    traceEdgeTimestamp[nearEdge.id] = timestampId;
+                    trace->edgeIds.push_back(nearEdge.id);
+                }
+                const Edge &edge = edges[nearEdge.id];
+                if (edge.die) {
+                    continue;
+                }
+                if (VertexSets::test(lastSet, next)) {
+                    //防止重边
+                    continue;
+                }
+                if (!CAN_CHANGE) {
+                    //没法变通道
+                    if (!edge.widthChannelTable[width * (CHANNEL_COUNT + 1) + lastChannel]) {
+                        continue;//不空闲直接结束
+                    }
+                    const int heuristic = stepCost * endDistance[next];
+                    if (nextBase + heuristic > maxResource) {
+                        continue;
+                    }
+                    SearchState &state = states[next][lastChannel];
+                    if (state.timestamp == timestampId && state.dist <= nextBase) {
+                        //访问过了，且距离没变得更近
+                        continue;
+                    }
+                    state.timestamp = timestampId;
+                    state.dist = nextBase;
+                    state.parentStartChannelEdgeId = (lastChannel << 16) + nearEdge.id;
+                    VertexSets::extend(parentVertexes.row(next * (CHANNEL_COUNT + 1) + lastChannel), lastSet,
+                                       setWords, lastVertex);
+                    q.push(nextBase + heuristicStep * endDistance[next], (lastChannel << 16) + next);
+                } else {
+                    //能变通道
+                    const int heuristic = stepCost * endDistance[next];
+                    if (nextBase + heuristic > maxResource) {
+                        //变通道只会更远
+                        continue;
+                    }
+                    const int *freeChannelTable = edge.freeChannelTable[width];
+                    for (int i = 1; i <= freeChannelTable[0]; ++i) {
+                        const int startChannel = freeChannelTable[i];
+                        //用来穷举
+                        int nextDistance = nextBase;
+                        if (startChannel != lastChannel) {
+                            nextDistance += changeChannelWeight;//变通道距离加1
+                            if (nextDistance + heuristic > maxResource) {
+                                continue;
+                            }
+                        }
+                        SearchState &state = states[next][startChannel];
+                        if (state.timestamp == timestampId && state.dist <= nextDistance) {
+                            //访问过了，且距离没变得更近
+                            continue;
+                        }
+                        state.timestamp = timestampId;
+                        state.dist = nextDistance;
+                        state.parentStartChannelEdgeId = (lastChannel << 16) + nearEdge.id;
+                        VertexSets::extend(parentVertexes.row(next * (CHANNEL_COUNT + 1) + startChannel),
+                                           lastSet, setWords, lastVertex);
+                        q.push(nextDistance + heuristicStep * endDistance[next], (startChannel << 16) + next);
+                    }
+                }
+            }
+        }
+
+        //宽度是模板参数，步长和通道表偏移都是常量；WIDTH为0是运行时宽度，给不常见的宽业务用
+        template<int WIDTH>
+        static vector<Point> aStarWidth(const int start, const int end, const int runtimeWidth,
+                                        const AdjacencyGraph &searchGraph,
+                                        const vector<Edge> &edges, const VertexStates &vertexStates,
+                                        const DistanceMatrix &minDistance, const int maxResource,
+                                        const int changeChannelWeight, SearchTrace *trace, Deadline *deadline,
+                                        const int heuristicWeight) {
+            const int width = WIDTH > 0 ? WIDTH : runtimeWidth;
+            AStarScratch &scratch = aStarScratch();
+            const int vertexCount = vertexStates.size();
+            scratch.parentVertexes.prepare(vertexCount * (CHANNEL_COUNT + 1), vertexCount);
+            int *traceVertexTimestamp = growTable(scratch.traceVertexStore, vertexCount);
+            StateRow *states = stateTable(scratch.stateStore, vertexCount);
+            FastQueue &q = scratch.q;
+            q.reserve(vertexCount);
+            q.clear();
+            const int timestampId = ++scratch.timestampId;
+            AStarSearch search;
+            search.states = states;
+            search.parentVertexes = &scratch.parentVertexes;
+            search.q = &q;
+            search.edges = &edges;
+            //图是无向的，距离矩阵对称，取终点那一行连续访问
+            search.endDistance = minDistance[end];
+            search.trace = trace;
+            search.traceEdgeTimestamp = growTable(scratch.traceEdgeStore, edges.size());
+            search.timestampId = timestampId;
+            search.setWords = scratch.parentVertexes.words;
+            search.width = width;
+            search.maxResource = maxResource;
+            search.changeChannelWeight = changeChannelWeight;
+            search.heuristicStep = width * EDGE_LENGTH_WEIGHT * heuristicWeight / HEURISTIC_WEIGHT_EXACT;
+            //往上丢是最好的，因为测试用例都往下丢，往上能流出更多空间
+            for (int i = 1; i <= CHANNEL_COUNT; ++i) {
+                states[start][i].dist = 0;
+                states[start][i].timestamp = timestampId;
+                scratch.parentVertexes.reset(start * (CHANNEL_COUNT + 1) + i);
+                q.push(minDistance[start][end] * search.heuristicStep, (i << 16) + start);
+            }
+            int endChannel = -1;
+            int popCount = 0;
+            while (!q.empty()) {
+                if (deadline != nullptr && (++popCount & (DEADLINE_CHECK_INTERVAL - 1)) == 0 && deadline->check()) {
+                    return {};
+                }
+                const int poll = q.pop();
+                scratch.expansions++;
+                const int lastChannel = poll >> 16;
+                const int lastVertex = poll & 0xFFFF;
+                const int lastDeep = states[lastVertex][lastChannel].dist;
+                if (lastVertex == end) {
+                    endChannel = lastChannel;
+                    break;
+                }
+                if (trace != nullptr && lastVertex != start && traceVertexTimestamp[lastVertex] != timestampId) {
+                    traceVertexTimestamp[lastVertex] = timestampId;
+                    trace->vertexIds.push_back(lastVertex);
+                }
+                const bool canChange = lastVertex != start && vertexStates.canChange(lastVertex);
+                const unsigned long long *lastSet = scratch.parentVertexes.row(
+                        lastVertex * (CHANNEL_COUNT + 1) + lastChannel);
+                if (canChange) {
+                    relaxEdges<WIDTH, true>(search, searchGraph[lastVertex], lastVertex, lastChannel, lastDeep,
+                                            lastSet);
+                } else {
+                    relaxEdges<WIDTH, false>(search, searchGraph[lastVertex], lastVertex, lastChannel, lastDeep,
+                                             lastSet);
+                }
+            }
+            if (endChannel == -1) {
+                return {};
+            }
+            vector<Point> path;
+            int cur = end;
+            int curStartChannel = endChannel;
+            while (cur != start) {
+                int edgeId = (states[cur][curStartChannel].parentStartChannelEdgeId & 0xFFFF);
+                path.push_back({edgeId, curStartChannel, curStartChannel + width - 1});
+                int startChannel = (states[cur][curStartChannel].parentStartChannelEdgeId >> 16);
+                cur = edges[edgeId].from == cur ? edges[edgeId].to : edges[edgeId].from;
+                curStartChannel = startChannel;
+            }
+            reverse(path.begin(), path.end());
+            int from = start;
+            unordered_set<int> keys;
+            keys.insert(from);
+            for (const Point &point: path) {
+                const Edge &edge = edges[point.edgeId];
+                int to = edge.from == from ? edge.to : edge.from;
+                if (keys.count(to)) {
+                    //顶点重复，锁死这个出边和下一个顶点好一点
+                    return {};
+                }
+                keys.insert(to);
+                from = to;
+            }
+            return path;
+        }
+
+        typedef vector<Point> (*AStarKernel)(int, int, int, const AdjacencyGraph &, const vector<Edge> &,
+                                             const VertexStates &, const DistanceMatrix &, int, int,
+                                             SearchTrace *, Deadline *, int);
+
+        //按宽度选一次内核，超过MAX_SPECIALIZED_WIDTH的走运行时宽度
+        //heuristicWeight大于100是加权aStar，先弹出离终点近的，找到的路径代价不超过最短的这么多倍，资源上限剪枝不加权
+        inline static vector<Point> aStar2(const int start, const int end, const int width,
+                                           const AdjacencyGraph &searchGraph,
+                                           const vector<Edge> &edges, const VertexStates &vertexStates,
+                                           const DistanceMatrix &minDistance, const int maxResource,
+                                           const int changeChannelWeight, SearchTrace *trace = nullptr,
+                                           Deadline *deadline = nullptr,
+                                           const int heuristicWeight = HEURISTIC_WEIGHT_EXACT) {
+            static const AStarKernel kernels[MAX_SPECIALIZED_WIDTH + 1] = {
+                    aStarWidth<0>, aStarWidth<1>, aStarWidth<2>, aStarWidth<3>, aStarWidth<4>,
+                    aStarWidth<5>, aStarWidth<6>, aStarWidth<7>, aStarWidth<8>};
+            const AStarKernel kernel = kernels[width <= MAX_SPECIALIZED_WIDTH ? width : 0];
+            return kernel(start, end, width, searchGraph, edges, vertexStates, minDistance, maxResource,
+                          changeChannelWeight, trace, deadline, heuristicWeight);
+        }
+
+        //双向aStar，反向状态(v,c)表示从v往终点的第一条边用通道c，两边在同一个顶点相遇：
+        //通道相同直接接上，不同要顶点能变通道，加一次变通道代价；任一边队首不小于当前最优就结束
+        //启发加权时队首不再是下界，结果代价不超过最短的权重倍
+        template<int WIDTH>
+        static vector<Point> aStarBidirectionalWidth(const int start, const int end, const int runtimeWidth,
+                                                     const AdjacencyGraph &searchGraph,
+                                                     const vector<Edge> &edges, const VertexStates &vertexStates,
+                                                     const DistanceMatrix &minDistance, const int maxResource,
+                                                     const int changeChannelWeight, SearchTrace *trace,
+                                                     Deadline *deadline, const int heuristicWeight) {
+            const int width = WIDTH > 0 ? WIDTH : runtimeWidth;
+            const int vertexCount = vertexStates.size();
+            AStarScratch *scratches[2] = {&aStarScratch(0), &aStarScratch(1)};
+            AStarSearch searches[2];
+            int *traceVertexTimestamps[2];
+            for (int side = 0; side < 2; side++) {
+                AStarScratch &scratch = *scratches[side];
+                scratch.parentVertexes.prepare(vertexCount * (CHANNEL_COUNT + 1), vertexCount);
+                traceVertexTimestamps[side] = growTable(scratch.traceVertexStore, vertexCount);
+                scratch.q.reserve(vertexCount);
+                scratch.q.clear();
+                AStarSearch &search = searches[side];
+                search.states = stateTable(scratch.stateStore, vertexCount);
+                search.parentVertexes = &scratch.parentVertexes;
+                search.q = &scratch.q;
+                search.edges = &edges;
+                //反向的启发是到起点的距离
+                search.endDistance = minDistance[side == 0 ? end : start];
+                search.trace = trace;
+                search.traceEdgeTimestamp = growTable(scratch.traceEdgeStore, edges.size());
+                search.timestampId = ++scratch.timestampId;
+                search.setWords = scratch.parentVertexes.words;
+                search.width = width;
+                search.maxResource = maxResource;
+                search.changeChannelWeight = changeChannelWeight;
+                search.heuristicStep = width * EDGE_LENGTH_WEIGHT * heuristicWeight / HEURISTIC_WEIGHT_EXACT;
+                const int source = side == 0 ? start : end;
+                for (int i = 1; i <= CHANNEL_COUNT; ++i) {
+                    search.states[source][i].dist = 0;
+                    search.states[source][i].timestamp = search.timestampId;
+                    scratch.parentVertexes.reset(source * (CHANNEL_COUNT + 1) + i);
+                    scratch.q.push(minDistance[start][end] * search.heuristicStep, (i << 16) + source);
+                }
+            }
+            const int setWords = searches[0].setWords;
+            int best = maxResource + 1;
+            int meetVertex = -1;
+            int meetChannels[2] = {};
+            int popCount = 0;
+            while (!scratches[0]->q.empty() && !scratches[1]->q.empty()) {
+                if (deadline != nullptr && (++popCount & (DEADLINE_CHECK_INTERVAL - 1)) == 0 && deadline->check()) {
+                    return {};
+                }
+                //展开小的一边
+                const int side = scratches[0]->q.size <= scratches[1]->q.size ? 0 : 1;
+                if (scratches[0]->q.topDist() >= best || scratches[1]->q.topDist() >= best) {
+                    break;
+                }
+                FastQueue &q = scratches[side]->q;
+                const AStarSearch &search = searches[side];
+                const AStarSearch &other = searches[side ^ 1];
+                const int poll = q.pop();
+                scratches[0]->expansions++;
+                const int lastChannel = poll >> 16;
+                const int lastVertex = poll & 0xFFFF;
+                const int lastDeep = search.states[lastVertex][lastChannel].dist;
+                const bool terminal = lastVertex == start || lastVertex == end;
+                if (trace != nullptr && !terminal && traceVertexTimestamps[side][lastVertex] != search.timestampId) {
+                    traceVertexTimestamps[side][lastVertex] = search.timestampId;
+                    trace->vertexIds.push_back(lastVertex);
+                }
+                const bool canChange = !terminal && vertexStates.canChange(lastVertex);
+                const unsigned long long *lastSet = search.parentVertexes->row(
+                        lastVertex * (CHANNEL_COUNT + 1) + lastChannel);
+                //和另一边到过这个顶点的状态接上，两边经过的顶点不能重复
+                const int firstChannel = canChange ? 1 : lastChannel;
+                const int lastOtherChannel = canChange ? CHANNEL_COUNT : lastChannel;
+                for (int channel = firstChannel; channel <= lastOtherChannel; channel++) {
+                    const SearchState &state = other.states[lastVertex][channel];
+                    if (state.timestamp != other.timestampId) {
+                        continue;
+                    }
+                    int cost = lastDeep + state.dist + (channel != lastChannel ? changeChannelWeight : 0);
+                    if (cost >= best) {
+                        continue;
+                    }
+                    const unsigned long long *otherSet = other.parentVertexes->row(
+                            lastVertex * (CHANNEL_COUNT + 1) + channel);
+                    bool overlap = false;
+                    for (int i = 0; i < setWords && !overlap; i++) {
+                        overlap = (lastSet[i] & otherSet[i]) != 0;
+                    }
+                    if (overlap) {
+                        continue;
+                    }
+                    best = cost;
+                    meetVertex = lastVertex;
+                    meetChannels[side] = lastChannel;
+                    meetChannels[side ^ 1] = channel;
+                }
+                if (lastVertex == (side == 0 ? end : start)) {
+                    //到了对面的起点，不能再穿过去
+                    continue;
+                }
+                if (canChange) {
+                    relaxEdges<WIDTH, true>(search, searchGraph[lastVertex], lastVertex, lastChannel, lastDeep,
+                                            lastSet);
+                } else {
+                    relaxEdges<WIDTH, false>(search, searchGraph[lastVertex], lastVertex, lastChannel, lastDeep,
+                                             lastSet);
+                }
+            }
+            if (meetVertex == -1) {
+                return {};
+            }
+            //正向部分从相遇点倒推到起点，反向部分从相遇点顺着走到终点
+            vector<Point> path;
+            for (int side = 0; side < 2; side++) {
+                StateRow *states = searches[side].states;
+                const int target = side == 0 ? start : end;
+                vector<Point> part;
+                int cur = meetVertex;
+                int curStartChannel = meetChannels[side];
+                while (cur != target) {
+                    int edgeId = (states[cur][curStartChannel].parentStartChannelEdgeId & 0xFFFF);
+                    part.push_back({edgeId, curStartChannel, curStartChannel + width - 1});
+                    int startChannel = (states[cur][curStartChannel].parentStartChannelEdgeId >> 16);
+                    cur = edges[edgeId].from == cur ? edges[edgeId].to : edges[edgeId].from;
+                    curStartChannel = startChannel;
+                }
+                if (side == 0) {
+                    path.assign(part.rbegin(), part.rend());
+                } else {
+                    path.insert(path.end(), part.begin(), part.end());
+                }
+            }
+            int from = start;
+            unordered_set<int> keys;
+            keys.insert(from);
+            for (const Point &point: path) {
+                const Edge &edge = edges[point.edgeId];
+                int to = edge.from == from ? edge.to : edge.from;
+                if (keys.count(to)) {
+                    return {};
+                }
+                keys.insert(to);
+                from = to;
+            }
+            return path;
+        }
+
+        inline static vector<Point> aStarBidirectional(const int start, const int end, const int width,
+                                                       const AdjacencyGraph &searchGraph,
+                                                       const vector<Edge> &edges, const VertexStates &vertexStates,
+                                                       const DistanceMatrix &minDistance, const int maxResource,
+                                                       const int changeChannelWeight, SearchTrace *trace = nullptr,
+                                                       Deadline *deadline = nullptr,
+                                                       const int heuristicWeight = HEURISTIC_WEIGHT_EXACT) {
+            static const AStarKernel kernels[MAX_SPECIALIZED_WIDTH + 1] = {
+                    aStarBidirectionalWidth<0>, aStarBidirectionalWidth<1>, aStarBidirectionalWidth<2>,
+                    aStarBidirectionalWidth<3>, aStarBidirectionalWidth<4>, aStarBidirectionalWidth<5>,
+                    aStarBidirectionalWidth<6>, aStarBidirectionalWidth<7>, aStarBidirectionalWidth<8>};
+            const AStarKernel kernel = kernels[width <= MAX_SPECIALIZED_WIDTH ? width : 0];
+            return kernel(start, end, width, searchGraph, edges, vertexStates, minDistance, maxResource,
+                          changeChannelWeight, trace, deadline, heuristicWeight);
+        }
+
+        //一个起点多个终点共用一棵搜索树，启发为到所有终点的最小距离，全部终点弹出或者超过资源上限结束，
+        //到了截止时间也结束，已经弹出的终点路径照样返回
+        inline static vector<vector<Point>> aStarMulti(const int start, const vector<int> &ends, const int width,
+                                                       const AdjacencyGraph &searchGraph,
+                                                       const vector<Edge> &edges, const VertexStates &vertexStates,
+                                                       const DistanceMatrix &minDistance,
+                                                       const int maxResource, const int changeChannelWeight,
+                                                       Deadline *deadline = nullptr) {
+            thread_local VertexSets parentVertexes;
+            thread_local vector<SearchState> stateStore;
+            thread_local vector<int> heuristicStore, endChannelStore;
+            const int vertexCount = vertexStates.size();
+            parentVertexes.prepare(vertexCount * (CHANNEL_COUNT + 1), vertexCount);
+            const int setWords = parentVertexes.words;
+            StateRow *states = stateTable(stateStore, vertexCount);
+            int *heuristic = growTable(heuristicStore, vertexCount);
+            int *endChannel = growTable(endChannelStore, vertexCount);
+            thread_local int timestampId = 1;
+            thread_local FastQueue q;
+            q.reserve(vertexCount);
+            q.clear();
+            timestampId++;
+            const int stepCost = width * EDGE_LENGTH_WEIGHT;
+            for (int v = 1; v < vertexStates.size(); ++v) {
+                int best = INT_INF;
+                for (int end: ends) {
+                    best = min(best, int(minDistance[end][v]));
+                }
+                heuristic[v] = best * stepCost;
+                endChannel[v] = 0;
+            }
+            int remainEnds = 0;
+            for (int end: ends) {
+                if (endChannel[end] == 0) {
+                    endChannel[end] = -1;//-1表示还没到达
+                    remainEnds++;
+                }
+            }
+            for (int i = 1; i <= CHANNEL_COUNT; ++i) {
+                states[start][i].dist = 0;
+                states[start][i].timestamp = timestampId;
+                parentVertexes.reset(start * (CHANNEL_COUNT + 1) + i);
+                q.push(heuristic[start], (i << 16) + start);
+            }
+            int popCount = 0;
+            while (!q.empty() && remainEnds > 0) {
+                if (deadline != nullptr && (++popCount & (DEADLINE_CHECK_INTERVAL - 1)) == 0 && deadline->check()) {
+                    break;
+                }
+                const int poll = q.pop();
+                const int lastChannel = poll >> 16;
+                const int lastVertex = poll & 0xFFFF;
+                const int lastDeep = states[lastVertex][lastChannel].dist;
+                if (endChannel[lastVertex] == -1) {
+                    endChannel[lastVertex] = lastChannel;
+                    remainEnds--;
+                }
+                const bool canChange = lastVertex != start && vertexStates.canChange(lastVertex);
+                const unsigned long long *lastSet = parentVertexes.row(lastVertex * (CHANNEL_COUNT + 1) + lastChannel);
+                for (const NearEdge &nearEdge: searchGraph[lastVertex]) {
+                    const int next = nearEdge.to;
+                    if (VertexSets::test(lastSet, next)) {
+                        continue;
+                    }
+                    const Edge &edge = edges[nearEdge.id];
+                    if (edge.die) {
+                        continue;
+                    }
+                    const int *freeChannelTable = edge.freeChannelTable[width];
+                    for (int i = 1; i <= freeChannelTable[0]; ++i) {
+                        const int startChannel = freeChannelTable[i];
+                        if (!canChange && startChannel != lastChannel) {
+                            continue;
+                        }
+                        int nextDistance = lastDeep + stepCost;
+                        if (startChannel != lastChannel) {
+                            nextDistance += changeChannelWeight;
+                        }
+                        if (states[next][startChannel].timestamp == timestampId &&
+                            states[next][startChannel].dist <= nextDistance) {
+                            continue;
+                        }
+                        if (nextDistance + heuristic[next] > maxResource) {
+                            continue;
+                        }
+                        states[next][startChannel].timestamp = timestampId;
+                        states[next][startChannel].dist = nextDistance;
+                        states[next][startChannel].parentStartChannelEdgeId = (lastChannel << 16) + nearEdge.id;
+                        VertexSets::extend(parentVertexes.row(next * (CHANNEL_COUNT + 1) + startChannel), lastSet, setWords,
+                                           lastVertex);
+                        q.push(nextDistance + heuristic[next], (startChannel << 16) + next);
+                    }
+                }
+            }
+            vector<vector<Point>> result(ends.size());
+            for (int k = 0; k < ends.size(); k++) {
+                const int end = ends[k];
+                if (endChannel[end] <= 0) {
+                    continue;
+                }
+                vector<Point> &path = result[k];
+                int cur = end;
+                int curStartChannel = endChannel[end];
+                while (cur != start) {
+                    int edgeId = (states[cur][curStartChannel].parentStartChannelEdgeId & 0xFFFF);
+                    path.push_back({edgeId, curStartChannel, curStartChannel + width - 1});
+                    int startChannel = (states[cur][curStartChannel].parentStartChannelEdgeId >> 16);
+                    cur = edges[edgeId].from == cur ? edges[edgeId].to : edges[edgeId].from;
+                    curStartChannel = startChannel;
+                }
+                reverse(path.begin(), path.end());
+            }
+            return result;
+        }
+
+    };
+
+    //路径缓存的key，资源上限不放进key，命中后再和缓存的代价比较
+    struct PathCacheKey {
+        int start;
+        int end;
+        int width;
+        int changeChannelWeight;
+        int heuristicWeight;//加权搜索的结果不是最短，分开缓存
+
+        bool operator==(const PathCacheKey &o) const {
+            return start == o.start && end == o.end && width == o.width
+                   && changeChannelWeight == o.changeChannelWeight && heuristicWeight == o.heuristicWeight;
+        }
+    };
+
+    struct PathCacheKeyHash {
+        size_t operator()(const PathCacheKey &key) const {
+            size_t h = (size_t) key.start;
+            h = h * 1000003u + (size_t) key.end;
+            h = h * 1000003u + (size_t) key.width;
+            h = h * 1000003u + (size_t) key.changeChannelWeight;
+            h = h * 1000003u + (size_t) key.heuristicWeight;
+            return h;
+        }
+    };
+
+    struct EdgeDependency {
+        int id;
+        long long generation;
+        Mask freeChannelMask;//死亡的边记为0
+    };
+
+    //缓存的结果，以及搜索时读过的边和顶点状态
+    struct PathCacheEntry {
+        vector<Point> path;
+        int cost;//找到路径时的代价
+        int maxResource;//没找到路径时的资源上限
+        vector<EdgeDependency> edgeDependencies;
+        vector<pair<int, bool>> vertexDependencies;//顶点能否变通道
+    };
+
+    struct PathCacheStatistics {
+        long long lookups;//查询次数
+        long long hits;//命中次数，版本号全部没变
+        long long revalidatedHits;//版本号变了，但是用到的掩码没变，依然命中
+        long long invalidations;//依赖变了，重新搜索
+        long long boundMisses;//依赖没变，但是资源上限比缓存的宽，重新搜索
+        long long clears;//超过上限清空次数
+        long long mismatches;//CHECK_PATH_CACHE时，命中的结果和重新搜索的代价不一样
+    };
+
+    //代价相同的路径选哪条和缓存里之前搜过什么有关，组合调度时主对象跑的参数和赢的克隆不一样，
+    //重放只跑赢的参数，缓存会走偏，所以记录和重放时都关掉
+    bool usePathCache = USE_PATH_CACHE;
+    unordered_map<PathCacheKey, PathCacheEntry, PathCacheKeyHash> pathCache;
+    PathCacheStatistics pathCacheStatistics{};
+    typename SearchUtils::SearchTrace searchTrace;
+
+    inline bool canChangeChannel(int v) const {
+        return vertexStates.canChange(v);
+    }
+
+    //返回0失效，1版本号没变，2版本号变了但是掩码没变
+    inline int checkPathCacheEntry(const PathCacheEntry &entry, int width) const {
+        int result = 1;
+        for (const EdgeDependency &dependency: entry.edgeDependencies) {
+            const Edge &edge = edges[dependency.id];
+            if (edge.generation == dependency.generation) {
+                continue;
+            }
+            if ((edge.die ? Mask() : edge.freeChannelMask[width]) != dependency.freeChannelMask) {
+                return 0;
+            }
+            result = 2;
+        }
+        for (const auto &item: entry.vertexDependencies) {
+            if (canChangeChannel(item.first) != item.second) {
+                return 0;
+            }
+        }
+        return result;
+    }
+
+    static int calculatesSearchCost(const vector<Point> &path, int width, int changeChannelWeight) {
+        int cost = 0;
+        for (int i = 0; i < path.size(); i++) {
+            cost += width * EDGE_LENGTH_WEIGHT;
+            if (i >= 1 && path[i - 1].startChannelId != path[i].startChannelId) {
+                cost += changeChannelWeight;
+            }
+        }
+        return cost;
+    }
+
+    //按距离选单向或者双向aStar，两个结果的代价相同；时间片小时dispatch打开加权启发
+    inline vector<Point> searchPath(int start, int end, int width, int maxResource, int changeChannelWeight,
+                                    typename SearchUtils::SearchTrace *trace) {
+        long long &expansions = SearchUtils::aStarScratch().expansions;
+        long long before = expansions;
+        vector<Point> path;
+        if (USE_BIDIRECTIONAL_SEARCH && minDistance[start][end] >= BIDIRECTIONAL_MIN_DISTANCE) {
+            path = SearchUtils::aStarBidirectional(start, end, width, searchGraph, edges, vertexStates, minDistance,
+                                                   maxResource, changeChannelWeight, trace, &searchDeadline,
+                                                   heuristicWeight);
+        } else {
+            path = SearchUtils::aStar2(start, end, width, searchGraph, edges, vertexStates, minDistance,
+                                       maxResource, changeChannelWeight, trace, &searchDeadline, heuristicWeight);
+        }
+        bool weighted = heuristicWeight != HEURISTIC_WEIGHT_EXACT;
+        (weighted ? searchStatistics.weightedSearches : searchStatistics.exactSearches)++;
+        (weighted ? searchStatistics.weightedExpansions : searchStatistics.exactExpansions) += expansions - before;
+        return path;
+    }
+
+    //带缓存的aStar寻路，搜索读过的边和顶点都没变时，结果只取决于资源上限:
+    //找到的路径代价不超过新上限就还是最优解，没找到时新上限不比原来大也一定找不到
+    inline vector<Point> cachedAStar(int start, int end, int width, int maxResource, int changeChannelWeight) {
+        if (!usePathCache) {
+            return searchPath(start, end, width, maxResource, changeChannelWeight, nullptr);
+        }
+        PathCacheKey key{start, end, width, changeChannelWeight, heuristicWeight};
+        pathCacheStatistics.lookups++;
+        auto it = pathCache.find(key);
+        if (it != pathCache.end()) {
+            const PathCacheEntry &entry = it->second;
+            int check = checkPathCacheEntry(entry, width);
+            if (check == 0) {
+                pathCacheStatistics.invalidations++;
+            } else if (!entry.path.empty() || maxResource <= entry.maxResource) {
+                if (check == 1) {
+                    pathCacheStatistics.hits++;
+                } else {
+                    pathCacheStatistics.revalidatedHits++;
+                }
+                const bool found = !entry.path.empty() && entry.cost <= maxResource;
+                if (CHECK_PATH_CACHE && heuristicWeight == HEURISTIC_WEIGHT_EXACT) {
+                    vector<Point> path = searchPath(start, end, width, maxResource, changeChannelWeight, nullptr);
+                    if (!searchDeadline.expired && (path.empty() == found || (found && calculatesSearchCost(
+                            path, width, changeChannelWeight) != entry.cost))) {
+                        pathCacheStatistics.mismatches++;
+                    }
+                }
+                if (!found) {
+                    return {};
+                }
+                return entry.path;
+            } else {
+                pathCacheStatistics.boundMisses++;
+            }
+        }
+        searchTrace.clear();
+        vector<Point> path = searchPath(start, end, width, maxResource, changeChannelWeight, &searchTrace);
+        if (searchDeadline.expired) {
+            //没搜完，不能当成找不到缓存
+            return path;
+        }
+        if (it == pathCache.end() && pathCache.size() >= PATH_CACHE_MAX_SIZE) {
+            pathCache.clear();
+            pathCacheStatistics.clears++;
+        }
+        PathCacheEntry &entry = pathCache[key];
+        entry.path = path;
+        entry.cost = calculatesSearchCost(path, width, changeChannelWeight);
+        entry.maxResource = maxResource;
+        entry.edgeDependencies.clear();
+        entry.vertexDependencies.clear();
+        for (int id: searchTrace.edgeIds) {
+            const Edge &edge = edges[id];
+            entry.edgeDependencies.push_back({id, edge.generation, edge.die ? Mask() : edge.freeChannelMask[width]});
+        }
+        for (int id: searchTrace.vertexIds) {
+            entry.vertexDependencies.emplace_back(id, canChangeChannel(id));
+        }
+        return path;
+    }
+
+    //增量寻路树(LPA*)，状态为(顶点,通道)，同一次断边多次重排之间复用，只修复变化的边和顶点影响到的状态
+    struct IncrementalTree {
+        int start{};
+        int end{};
+        int width{};
+        int changeChannelWeight{};
+        int goalState{};//虚拟终点，前驱为终点的所有通道，代价0
+        vector<int> g;
+        vector<int> rhs;
+        vector<int> parentState;
+        vector<int> parentEdgeId;
+        vector<Mask> edgeMasks;//上次搜索时每条边能用的起始通道
+        vector<bool> vertexCanChange;//上次搜索时顶点能否变通道
+        int changedEdgePosition{};//上次修复到变化日志的哪里
+        int changedVertexPosition{};
+
+        struct QueueItem {
+            long long k1;
+            long long k2;
+            int state;
+
+            bool operator<(const QueueItem &o) const {
+                return k1 != o.k1 ? k1 > o.k1 : k2 > o.k2;
+            }
+        };
+
+        priority_queue<QueueItem> q;
+    };
+
+    struct IncrementalSearchStatistics {
+        long long searches;//总搜索次数
+        long long repairs;//复用已有搜索树的次数
+        long long expansions;//弹出扩展的状态数
+        long long fallbacks;//结果有重复顶点，退回aStar2的次数
+        long long capped;//搜索树个数到了上限，用aStar2的次数
+        long long maxTrees;//一次调度最多建了几棵树
+        long long treeBytes;//每棵树占的内存
+    };
+
+    bool incrementalSearchEnabled = USE_INCREMENTAL_SEARCH;//重放时可以关掉，和打开的用时对比
+    bool useIncrementalSearch = false;//dispatch决定，重排多次时打开
+    vector<IncrementalTree> incrementalTrees;
+    unordered_map<int, int> incrementalTreeIndex;//业务id到搜索树
+    int incrementalTreeCount = 0;//当前使用中的搜索树个数，数组本身复用不释放
+    //本次调度里通道表更新过的边和变通道次数变过的顶点，按时间追加，可能重复，每棵树只修复自己上次之后的部分
+    vector<int> incrementalChangedEdges;
+    vector<int> incrementalChangedVertices;
+    IncrementalSearchStatistics incrementalStatistics{};
+
+    inline Mask liveChannelMask(int edgeId, int width) const {
+        const Edge &edge = edges[edgeId];
+        return edge.die ? Mask() : edge.freeChannelMask[width];
+    }
+
+    inline void incrementalPush(IncrementalTree &tree, int state) {
+        long long minG = min(tree.g[state], tree.rhs[state]);
+        long long h = 0;
+        if (state != tree.goalState) {
+            h = 1LL * minDistance[state / (CHANNEL_COUNT + 1)][tree.end] * tree.width * EDGE_LENGTH_WEIGHT;
+        }
+        tree.q.push({minG + h, minG, state});
+    }
+
+    inline void incrementalUpdateRhs(IncrementalTree &tree, int state, int value, int parent, int edgeId) {
+        if (value < tree.rhs[state]) {
+            tree.rhs[state] = value;
+            tree.parentState[state] = parent;
+            tree.parentEdgeId[state] = edgeId;
+            incrementalPush(tree, state);
+        }
+    }
+
+    //按所有前驱重新计算rhs
+    inline void incrementalRecompute(IncrementalTree &tree, int state) {
+        const int channelStride = CHANNEL_COUNT + 1;
+        int best = INCREMENTAL_INF;
+        int bestParent = -1;
+        int bestEdgeId = -1;
+        if (state == tree.goalState) {
+            for (int c = 1; c <= CHANNEL_COUNT; ++c) {
+                int cur = tree.g[tree.end * channelStride + c];
+                if (cur < best) {
+                    best = cur;
+                    bestParent = tree.end * channelStride + c;
+                }
+            }
+        } else {
+            const int v = state / channelStride;
+            const int channel = state % channelStride;
+            if (v == tree.start) {
+                return;//起点固定为0
+            }
+            const int stepCost = tree.width * EDGE_LENGTH_WEIGHT;
+            for (const NearEdge &nearEdge: searchGraph[v]) {
+                if (!liveChannelMask(nearEdge.id, tree.width).test(channel)) {
+                    continue;
+                }
+                const int u = nearEdge.to;
+                if (u == tree.end) {
+                    continue;
+                }
+                const int *gu = &tree.g[u * channelStride];
+                if (gu[channel] + stepCost < best) {
+                    best = gu[channel] + stepCost;
+                    bestParent = u * channelStride + channel;
+                    bestEdgeId = nearEdge.id;
+                }
+                if (u != tree.start && canChangeChannel(u)) {
+                    for (int c = 1; c <= CHANNEL_COUNT; ++c) {
+                        if (c != channel && gu[c] + stepCost + tree.changeChannelWeight < best) {
+                            best = gu[c] + stepCost + tree.changeChannelWeight;
+                            bestParent = u * channelStride + c;
+                            bestEdgeId = nearEdge.id;
+                        }
+                    }
+                }
+            }
+        }
+        tree.rhs[state] = best;
+        tree.parentState[state] = bestParent;
+        tree.parentEdgeId[state] = bestEdgeId;
+        if (tree.g[state] != tree.rhs[state]) {
+            incrementalPush(tree, state);
+        }
+    }
+
+    //g变小后松弛后继
+    inline void incrementalRelaxSuccessors(IncrementalTree &tree, int state) {
+        const int channelStride = CHANNEL_COUNT + 1;
+        const int u = state / channelStride;
+        const int channel = state % channelStride;
+        const int gu = tree.g[state];
+        if (u == tree.end) {
+            incrementalUpdateRhs(tree, tree.goalState, gu, state, -1);
+            return;
+        }
+        const int stepCost = tree.width * EDGE_LENGTH_WEIGHT;
+        const bool canChange = u != tree.start && canChangeChannel(u);
+        for (const NearEdge &nearEdge: searchGraph[u]) {
+            const int v = nearEdge.to;
+            if (v == tree.start) {
+                continue;
+            }
+            Mask mask = liveChannelMask(nearEdge.id, tree.width);
+            if (!canChange) {
+                if (mask.test(channel)) {
+                    incrementalUpdateRhs(tree, v * channelStride + channel, gu + stepCost, state, nearEdge.id);
+                }
+                continue;
+            }
+            while (mask.any()) {
+                const int next = mask.lowest();
+                mask.clearLowest();
+                int cost = gu + stepCost + (next != channel ? tree.changeChannelWeight : 0);
+                incrementalUpdateRhs(tree, v * channelStride + next, cost, state, nearEdge.id);
+            }
+        }
+    }
+
+    //g变成无穷后，以它为父亲的后继全部重算
+    inline void incrementalRaiseSuccessors(IncrementalTree &tree, int state) {
+        const int channelStride = CHANNEL_COUNT + 1;
+        const int u = state / channelStride;
+        if (u == tree.end) {
+            if (tree.parentState[tree.goalState] == state) {
+                incrementalRecompute(tree, tree.goalState);
+            }
+            return;
+        }
+        for (const NearEdge &nearEdge: searchGraph[u]) {
+            const int v = nearEdge.to;
+            if (v == tree.start) {
+                continue;
+            }
+            for (int c = 1; c <= CHANNEL_COUNT; ++c) {
+                const int next = v * channelStride + c;
+                if (tree.parentState[next] == state && tree.parentEdgeId[next] == nearEdge.id) {
+                    incrementalRecompute(tree, next);
+                }
+            }
+        }
+    }
+
+    //边或者顶点状态变了，修复受影响的状态
+    inline void incrementalApplyChanges(IncrementalTree &tree) {
+        const int channelStride = CHANNEL_COUNT + 1;
+        const int stepCost = tree.width * EDGE_LENGTH_WEIGHT;
+        for (int k = tree.changedVertexPosition; k < incrementalChangedVertices.size(); ++k) {
+            const int u = incrementalChangedVertices[k];
+            const bool canChange = canChangeChannel(u);
+            if (canChange == tree.vertexCanChange[u]) {
+                continue;
+            }
+            tree.vertexCanChange[u] = canChange;
+            if (u == tree.start || u == tree.end) {
+                continue;
+            }
+            for (const NearEdge &nearEdge: searchGraph[u]) {
+                const int v = nearEdge.to;
+                if (v == tree.start) {
+                    continue;
+                }
+                Mask mask = liveChannelMask(nearEdge.id, tree.width);
+                while (mask.any()) {
+                    const int channel = mask.lowest();
+                    mask.clearLowest();
+                    const int next = v * channelStride + channel;
+                    if (canChange) {
+                        for (int c = 1; c <= CHANNEL_COUNT; ++c) {
+                            if (c != channel && tree.g[u * channelStride + c] < INCREMENTAL_INF) {
+                                incrementalUpdateRhs(tree, next,
+                                                     tree.g[u * channelStride + c] + stepCost +
+                                                     tree.changeChannelWeight,
+                                                     u * channelStride + c, nearEdge.id);
+                            }
+                        }
+                    } else if (tree.parentEdgeId[next] == nearEdge.id
+                               && tree.parentState[next] != u * channelStride + channel) {
+                        incrementalRecompute(tree, next);
+                    }
+                }
+            }
+        }
+        for (int k = tree.changedEdgePosition; k < incrementalChangedEdges.size(); ++k) {
+            const int e = incrementalChangedEdges[k];
+            const Mask mask = liveChannelMask(e, tree.width);
+            const Mask oldMask = tree.edgeMasks[e];
+            if (mask == oldMask) {
+                continue;
+            }
+            tree.edgeMasks[e] = mask;
+            for (int direction = 0; direction < 2; ++direction) {
+                const int u = direction == 0 ? edges[e].from : edges[e].to;
+                const int v = direction == 0 ? edges[e].to : edges[e].from;
+                if (v == tree.start || u == tree.end) {
+                    continue;
+                }
+                const bool canChange = u != tree.start && canChangeChannel(u);
+                Mask added = mask & ~oldMask;
+                while (added.any()) {
+                    const int channel = added.lowest();
+                    added.clearLowest();
+                    const int next = v * channelStride + channel;
+                    const int *gu = &tree.g[u * channelStride];
+                    if (gu[channel] < INCREMENTAL_INF) {
+                        incrementalUpdateRhs(tree, next, gu[channel] + stepCost, u * channelStride + channel, e);
+                    }
+                    if (canChange) {
+                        for (int c = 1; c <= CHANNEL_COUNT; ++c) {
+                            if (c != channel && gu[c] < INCREMENTAL_INF) {
+                                incrementalUpdateRhs(tree, next, gu[c] + stepCost + tree.changeChannelWeight,
+                                                     u * channelStride + c, e);
+                            }
+                        }
+                    }
+                }
+                Mask removed = oldMask & ~mask;
+                while (removed.any()) {
+                    const int channel = removed.lowest();
+                    removed.clearLowest();
+                    const int next = v * channelStride + channel;
+                    if (tree.parentEdgeId[next] == e && tree.parentState[next] / channelStride == u) {
+                        incrementalRecompute(tree, next);
+                    }
+                }
+            }
+        }
+        tree.changedEdgePosition = int(incrementalChangedEdges.size());
+        tree.changedVertexPosition = int(incrementalChangedVertices.size());
+    }
+
+    inline void incrementalInitTree(IncrementalTree &tree, int start, int end, int width, int changeChannelWeight) {
+        const int channelStride = CHANNEL_COUNT + 1;
+        const int stateCount = (N + 1) * channelStride + 1;
+        tree.start = start;
+        tree.end = end;
+        tree.width = width;
+        tree.changeChannelWeight = changeChannelWeight;
+        tree.goalState = stateCount - 1;
+        tree.g.assign(stateCount, INCREMENTAL_INF);
+        tree.rhs.assign(stateCount, INCREMENTAL_INF);
+        tree.parentState.assign(stateCount, -1);
+        tree.parentEdgeId.assign(stateCount, -1);
+        tree.edgeMasks.resize(edges.size());
+        for (int e = 1; e < edges.size(); ++e) {
+            tree.edgeMasks[e] = liveChannelMask(e, width);
+        }
+        tree.vertexCanChange.resize(N + 1);
+        for (int i = 1; i <= N; ++i) {
+            tree.vertexCanChange[i] = canChangeChannel(i);
+        }
+        tree.changedEdgePosition = int(incrementalChangedEdges.size());
+        tree.changedVertexPosition = int(incrementalChangedVertices.size());
+        tree.q = priority_queue<typename IncrementalTree::QueueItem>();
+        for (int c = 1; c <= CHANNEL_COUNT; ++c) {
+            tree.rhs[start * channelStride + c] = 0;
+            incrementalPush(tree, start * channelStride + c);
+        }
+    }
+
+    //增量寻路，同一个业务第二次开始只修复变化的部分，结果和aStar2同样是资源上限内的最短路
+    inline vector<Point> incrementalFindPath(int busId, int start, int end, int width, int maxResource,
+                                             int changeChannelWeight) {
+        const int channelStride = CHANNEL_COUNT + 1;
+        incrementalStatistics.searches++;
+        auto it = incrementalTreeIndex.find(busId);
+        IncrementalTree *treePointer;
+        if (it == incrementalTreeIndex.end()) {
+            //每棵树(N+1)*(C+1)个状态四个数组，加每条边的掩码，大图上建满就不再建
+            const long long treeBytes = 4LL * sizeof(int) * ((N + 1) * channelStride + 1)
+                                        + 1LL * sizeof(Mask) * edges.size() + N / 8 + 1;
+            incrementalStatistics.treeBytes = treeBytes;
+            if (incrementalTreeCount >= INCREMENTAL_SEARCH_MAX_BYTES / treeBytes) {
+                incrementalStatistics.capped++;
+                return cachedAStar(start, end, width, maxResource, changeChannelWeight);
+            }
+            if (incrementalTreeCount == incrementalTrees.size()) {
+                incrementalTrees.emplace_back();
+            }
+            incrementalTreeIndex[busId] = incrementalTreeCount;
+            treePointer = &incrementalTrees[incrementalTreeCount++];
+            incrementalStatistics.maxTrees = max(incrementalStatistics.maxTrees, (long long) incrementalTreeCount);
+            incrementalInitTree(*treePointer, start, end, width, changeChannelWeight);
+        } else {
+            treePointer = &incrementalTrees[it->second];
+            incrementalStatistics.repairs++;
+            incrementalApplyChanges(*treePointer);
+        }
+        IncrementalTree &tree = *treePointer;
+        auto keyOf = [&](int state) {
+            long long minG = min(tree.g[state], tree.rhs[state]);
+            long long h = state == tree.goalState ? 0 :
+                          1LL * minDistance[state / channelStride][end] * width * EDGE_LENGTH_WEIGHT;
+            return make_pair(minG + h, minG);
+        };
+        int popCount = 0;
+        while (!tree.q.empty()) {
+            //每次弹出都把树留在一致的状态，中途到了截止时间直接返回，下次修复接着弹
+            if ((++popCount & (DEADLINE_CHECK_INTERVAL - 1)) == 0 && searchDeadline.check()) {
+                return {};
+            }
+            const typename IncrementalTree::QueueItem top = tree.q.top();
+            const int state = top.state;
+            if (tree.g[state] == tree.rhs[state] || keyOf(state) != make_pair(top.k1, top.k2)) {
+                tree.q.pop();//过期的
+                continue;
+            }
+            const pair<long long, long long> goalKey = keyOf(tree.goalState);
+            if (!(make_pair(top.k1, top.k2) < goalKey || tree.rhs[tree.goalState] != tree.g[tree.goalState])) {
+                break;
+            }
+            if (top.k1 > maxResource) {
+                break;
+            }
+            tree.q.pop();
+            incrementalStatistics.expansions++;
+            if (tree.g[state] > tree.rhs[state]) {
+                tree.g[state] = tree.rhs[state];
+                if (state != tree.goalState) {
+                    incrementalRelaxSuccessors(tree, state);
+                }
+            } else {
+                tree.g[state] = INCREMENTAL_INF;
+                incrementalRecompute(tree, state);
+                if (state != tree.goalState) {
+                    incrementalRaiseSuccessors(tree, state);
+                }
+            }
+        }
+        const int cost = tree.g[tree.goalState];
+        if (cost != tree.rhs[tree.goalState] || cost > maxResource) {
+            return {};
+        }
+        //按g值从终点往回找前驱，存的父亲是rhs的来源，修复过程中可能指向不一致的状态
+        vector<Point> path;
+        unordered_set<int> keys;
+        keys.insert(end);
+        int state = -1;
+        for (int c = 1; c <= CHANNEL_COUNT; ++c) {
+            if (tree.g[end * channelStride + c] == cost) {
+                state = end * channelStride + c;
+                break;
+            }
+        }
+        const int stepCost = width * EDGE_LENGTH_WEIGHT;
+        while (state != -1 && state / channelStride != start) {
+            const int v = state / channelStride;
+            const int channel = state % channelStride;
+            int parent = -1;
+            int parentEdgeId = -1;
+            for (const NearEdge &nearEdge: searchGraph[v]) {
+                if (!liveChannelMask(nearEdge.id, width).test(channel)) {
+                    continue;
+                }
+                const int u = nearEdge.to;
+                if (u == end) {
+                    continue;
+                }
+                const int *gu = &tree.g[u * channelStride];
+                if (gu[channel] + stepCost == tree.g[state]) {
+                    parent = u * channelStride + channel;
+                    parentEdgeId = nearEdge.id;
+                    break;
+                }
+                if (u != start && canChangeChannel(u)) {
+                    for (int c = 1; c <= CHANNEL_COUNT; ++c) {
+                        if (c != channel && gu[c] + stepCost + changeChannelWeight == tree.g[state]) {
+                            parent = u * channelStride + c;
+                            parentEdgeId = nearEdge.id;
+                            break;
+                        }
+                    }
+                    if (parent != -1) {
+                        break;
+                    }
+                }
+            }
+            if (parent == -1 || path.size() > N) {
+                path.clear();
+                break;
+            }
+            path.push_back({parentEdgeId, channel, channel + width - 1});
+            state = parent;
+            if (state / channelStride != start && !keys.insert(state / channelStride).second) {
+                path.clear();
+                break;
+            }
+        }
+        if (path.empty()) {
+            //最短的是带环的走法，aStar2带父节点约束能找到简单路径
+            incrementalStatistics.fallbacks++;
+            return cachedAStar(start, end, width, maxResource, changeChannelWeight);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+
+    inline void clearIncrementalTrees() {
+        incrementalTreeIndex.clear();
+        incrementalTreeCount = 0;
+        incrementalChangedEdges.clear();
+        incrementalChangedVertices.clear();
+    }
+
+    //预计算的候选路径，每个(起点,终点)按跳数保存K条最短无环路径，断边时只用掩码检查能不能直接用
+    vector<int> candidateRouteEdges;//所有候选路径的边拼在一起
+    vector<int> candidateRouteOffsets;//第i条路径的边为[offsets[i],offsets[i+1])
+    vector<pair<int, int>> busCandidateRoutes;//每个业务的候选路径编号范围[first,second)
+    int candidateRouteBusinessCount = -1;//建了候选路径的业务数，init前设好就按这个建，不按时间
+    bool useCandidateRouteOnly = false;//dispatch决定，时间片太小时候选路径能用就不再搜索
+    int heuristicWeight = HEURISTIC_WEIGHT_EXACT;//dispatch决定，时间片小时用加权启发
+
+    struct SearchStatistics {
+        long long exactSearches;//普通aStar次数
+        long long exactExpansions;//普通aStar弹出状态数
+        long long weightedSearches;//加权启发次数
+        long long weightedExpansions;//加权启发弹出状态数
+    };
+
+    SearchStatistics searchStatistics{};
+
+    struct CandidateRouteStatistics {
+        long long checks;//检查次数
+        long long optimalHits;//候选路径就是最短路，不用搜索
+        long long fastHits;//时间片太小，直接用候选路径
+        long long misses;//没有能用的候选路径
+    };
+
+    CandidateRouteStatistics candidateRouteStatistics{};
+
+    struct SharedSearchStatistics {
+        long long groups;//共用搜索树的组数
+        long long members;//组里的业务数
+        long long hits;//直接用了共用树上的路径
+        long long invalidated;//前面业务占了资源，重新单独搜索
+    };
+
+    SharedSearchStatistics sharedSearchStatistics{};
+
+    struct DeadlineStatistics {
+        long long interruptedPasses;//调度过程中到了截止时间被中断的次数
+    };
+
+    DeadlineStatistics deadlineStatistics{};
+
+    //时间预算，每次断边的时间按权重分，没用完的自动留给后面的断边
+    struct TimeBudget {
+        double weightSum;//已经处理的断边权重和
+        int eventCount;//已经处理的断边数
+        int remainEventCount;//估计还剩的断边数，包括当前这条，0表示按MAX_E_FAIL_COUNT估计
+    };
+
+    TimeBudget timeBudget{};
+
+    //寻路参数，组合调度时每个克隆一组
+    struct SearchConfig {
+        int myChangeChannelWeight;//我的样例寻路变通道权重
+        int otherChangeChannelWeight;//他的样例寻路变通道权重
+        double mySearchResourceFactor;//我的样例额外资源缩放因子
+        double otherSearchResourceFactor;//他的样例额外资源缩放因子
+        int needHelpValueMode;//平均影响价值的算法，0初始平均，1剩余平均，2当前断边
+    };
+
+    SearchConfig searchConfig{1, 1, MY_SAMPLE_SEARCH_RESOURCE_FACTOR, OTHER_SAMPLE_SEARCH_RESOURCE_FACTOR, 0};
+    int resourceChangeChannelWeight = 1;//变通道占的资源，init按拥有变通道能力的顶点数算
+
+    //按跳数的最短路，禁用的边和顶点用时间戳标记
+    bool hopShortestPath(int from, int to, const vector<int> &bannedEdgeStamp, const vector<int> &bannedVertexStamp,
+                         int stamp, vector<int> &pathEdgeIds) {
+        thread_local vector<int> parentEdgeId, visitStamp;
+        thread_local int visitId = 0;
+        parentEdgeId.resize(N + 1);
+        visitStamp.resize(N + 1);
+        visitId++;
+        queue<int> q;
+        q.push(from);
+        visitStamp[from] = visitId;
+        while (!q.empty() && visitStamp[to] != visitId) {
+            int cur = q.front();
+            q.pop();
+            for (const NearEdge &nearEdge: graph[cur]) {
+                if (bannedEdgeStamp[nearEdge.id] == stamp || bannedVertexStamp[nearEdge.to] == stamp
+                    || visitStamp[nearEdge.to] == visitId) {
+                    continue;
+                }
+                visitStamp[nearEdge.to] = visitId;
+                parentEdgeId[nearEdge.to] = nearEdge.id;
+                q.push(nearEdge.to);
+            }
+        }
+        if (visitStamp[to] != visitId) {
+            return false;
+        }
+        pathEdgeIds.clear();
+        int cur = to;
+        while (cur != from) {
+            int edgeId = parentEdgeId[cur];
+            pathEdgeIds.push_back(edgeId);
+            cur = edges[edgeId].from == cur ? edges[edgeId].to : edges[edgeId].from;
+        }
+        reverse(pathEdgeIds.begin(), pathEdgeIds.end());
+        return true;
+    }
+
+    //Yen算法，返回按跳数排序的k条无环路径
+    vector<vector<int>> yenKShortestRoutes(int from, int to, int k) {
+        thread_local vector<int> bannedEdgeStamp, bannedVertexStamp;
+        thread_local int stamp = 0;
+        bannedEdgeStamp.resize(edges.size());
+        bannedVertexStamp.resize(N + 1);
+        vector<vector<int>> result;
+        vector<vector<int>> candidates;
+        vector<int> path;
+        stamp++;
+        if (!hopShortestPath(from, to, bannedEdgeStamp, bannedVertexStamp, stamp, path)) {
+            return result;
+        }
+        result.push_back(path);
+        while (result.size() < k) {
+            const vector<int> last = result.back();
+            vector<int> routeVertices;
+            routeVertices.push_back(from);
+            for (int edgeId: last) {
+                int cur = routeVertices.back();
+                routeVertices.push_back(edges[edgeId].from == cur ? edges[edgeId].to : edges[edgeId].from);
+            }
+            for (int i = 0; i < last.size(); i++) {
+                stamp++;
+                for (const vector<int> &route: result) {
+                    if (route.size() > i && equal(route.begin(), route.begin() + i, last.begin())) {
+                        bannedEdgeStamp[route[i]] = stamp;
+                    }
+                }
+                for (int j = 0; j < i; j++) {
+                    bannedVertexStamp[routeVertices[j]] = stamp;
+                }
+                if (!hopShortestPath(routeVertices[i], to, bannedEdgeStamp, bannedVertexStamp, stamp, path)) {
+                    continue;
+                }
+                vector<int> total(last.begin(), last.begin() + i);
+                total.insert(total.end(), path.begin(), path.end());
+                if (find(candidates.begin(), candidates.end(), total) == candidates.end()
+                    && find(result.begin(), result.end(), total) == result.end()) {
+                    candidates.push_back(total);
+                }
+            }
+            if (candidates.empty()) {
+                break;
+            }
+            int bestIndex = 0;
+            for (int i = 1; i < candidates.size(); i++) {
+                if (candidates[i].size() < candidates[bestIndex].size()) {
+                    bestIndex = i;
+                }
+            }
+            result.push_back(candidates[bestIndex]);
+            candidates.erase(candidates.begin() + bestIndex);
+        }
+        return result;
+    }
+
+    //init时给每个业务建候选路径索引，相同(起点,终点)的业务共用，超时就不再建
+    void buildCandidateRoutes() {
+        candidateRouteEdges.clear();
+        candidateRouteOffsets.assign(1, 0);
+        busCandidateRoutes.assign(buses.size(), {0, 0});
+        unordered_map<long long, pair<int, int>> pairRoutes;
+        int startTime = runtime();
+        int i = 1;
+        for (; i < buses.size(); i++) {
+            if (candidateRouteBusinessCount >= 0 ? i > candidateRouteBusinessCount
+                                                 : runtime() - startTime > CANDIDATE_ROUTE_MAX_TIME) {
+                break;
+            }
+            const Business &business = buses[i];
+            long long key = 1LL * business.from * (N + 1) + business.to;
+            auto it = pairRoutes.find(key);
+            if (it != pairRoutes.end()) {
+                busCandidateRoutes[i] = it->second;
+                continue;
+            }
+            int first = int(candidateRouteOffsets.size()) - 1;
+            for (const vector<int> &route: yenKShortestRoutes(business.from, business.to, CANDIDATE_ROUTE_COUNT)) {
+                candidateRouteEdges.insert(candidateRouteEdges.end(), route.begin(), route.end());
+                candidateRouteOffsets.push_back(int(candidateRouteEdges.size()));
+            }
+            pair<int, int> range(first, int(candidateRouteOffsets.size()) - 1);
+            pairRoutes[key] = range;
+            busCandidateRoutes[i] = range;
+        }
+        candidateRouteBusinessCount = i - 1;
+    }
+
+    //第一条单通道就能放下的候选路径，候选按跳数排序，找到的就是候选里最短的
+    inline vector<Point> findCandidateRoute(const Business &business, int maxResource) {
+        candidateRouteStatistics.checks++;
+        const int width = business.needChannelLength;
+        const pair<int, int> &range = busCandidateRoutes[business.id];
+        for (int r = range.first; r < range.second; r++) {
+            const int begin = candidateRouteOffsets[r];
+            const int end = candidateRouteOffsets[r + 1];
+            if ((end - begin) * width * EDGE_LENGTH_WEIGHT > maxResource) {
+                break;
+            }
+            Mask mask = Mask::full();
+            for (int j = begin; j < end && mask.any(); j++) {
+                mask &= liveChannelMask(candidateRouteEdges[j], width);
+            }
+            if (!mask.any()) {
+                continue;
+            }
+            const int channel = mask.lowest();
+            vector<Point> path;
+            for (int j = begin; j < end; j++) {
+                path.push_back({candidateRouteEdges[j], channel, channel + width - 1});
+            }
+            return path;
+        }
+        candidateRouteStatistics.misses++;
+        return {};
+    }
+
+    void printStatistics() const {
+        const PathCacheStatistics &s = pathCacheStatistics;
+        long long totalHits = s.hits + s.revalidatedHits;
+        fprintf(stderr, "pathCache lookups:%lld hits:%lld(%.2f%%) revalidatedHits:%lld invalidations:%lld"
+                        " boundMisses:%lld clears:%lld mismatches:%lld\n",
+                s.lookups, totalHits, s.lookups == 0 ? 0.0 : 100.0 * totalHits / s.lookups, s.revalidatedHits,
+                s.invalidations, s.boundMisses, s.clears, s.mismatches);
+        const IncrementalSearchStatistics &t = incrementalStatistics;
+        fprintf(stderr, "incrementalSearch searches:%lld repairs:%lld expansions:%lld fallbacks:%lld capped:%lld"
+                        " maxTrees:%lld treeBytes:%lld\n",
+                t.searches, t.repairs, t.expansions, t.fallbacks, t.capped, t.maxTrees, t.treeBytes);
+        const CandidateRouteStatistics &c = candidateRouteStatistics;
+        if (speculation) {
+            const SpeculationStatistics &p = speculation->statistics;
+            fprintf(stderr, "speculation started:%lld hits:%lld unfinishedHits:%lld misses:%lld\n",
+                    p.started, p.hits, p.unfinishedHits, p.misses);
+        }
+        const SharedSearchStatistics &m = sharedSearchStatistics;
+        fprintf(stderr, "sharedSearch groups:%lld members:%lld hits:%lld invalidated:%lld\n",
+                m.groups, m.members, m.hits, m.invalidated);
+        fprintf(stderr, "deadline interruptedPasses:%lld\n", deadlineStatistics.interruptedPasses);
+        const CapabilityStatistics &b = capabilityStatistics;
+        fprintf(stderr, "capability moves:%lld accepted:%lld skipped:%lld simulations:%lld lost:%d->%d\n",
+                b.moves, b.accepted, b.skipped, b.simulations, b.initialLost, b.finalLost);
+        const SampleStatistics &g = sampleStatistics;
+        fprintf(stderr, "samples value:%d generations:%lld offspring:%lld replacements:%lld\n",
+                g.value, g.generations, g.offspring, g.replacements);
+        fprintf(stderr, "surrogate trained:%d generated:%lld promoted:%lld correlation:%.3f\n",
+                surrogate.sampleCount, surrogate.generated, surrogate.promoted, surrogate.correlation());
+        const SearchStatistics &a = searchStatistics;
+        fprintf(stderr, "aStar exact:%lld expansions:%lld weighted:%lld expansions:%lld\n",
+                a.exactSearches, a.exactExpansions, a.weightedSearches, a.weightedExpansions);
+        TaskPool &pool = getPool();
+        fprintf(stderr, "taskPool workers:%d batches:%lld tasks:%lld steals:%lld skipped:%lld\n", pool.size(),
+                pool.statistics.batches.load(), pool.statistics.tasks.load(), pool.statistics.steals.load(),
+                pool.statistics.skipped.load());
+        if (portfolio) {
+            const PortfolioContext &o = *portfolio;
+            fprintf(stderr, "portfolio dispatches:%lld", o.dispatches);
+            for (int i = 0; i < o.configs.size(); i++) {
+                fprintf(stderr, " config%d:%lld/%lld", i, o.wins[i], o.runs[i]);
+            }
+            fprintf(stderr, "\n");
+        }
+        fprintf(stderr, "candidateRoute routes:%d checks:%lld optimalHits:%lld fastHits:%lld misses:%lld\n",
+                int(candidateRouteOffsets.size()) - 1, c.checks, c.optimalHits, c.fastHits, c.misses);
+    }
+
+    //恢复场景
+    void reset() {
+        //恢复边和顶点状态，内容没变的边不重新打表，版本号不变，路径缓存可以跨场景复用
+        vector<int> oldChannels(edges.size() * (CHANNEL_COUNT + 1));
+        vector<bool> oldDie(edges.size());
+        for (int i = 1; i < edges.size(); i++) {
+            memcpy(&oldChannels[i * (CHANNEL_COUNT + 1)], edges[i].channel, sizeof(edges[i].channel));
+            oldDie[i] = edges[i].die;
+            edges[i].reset();
+        }
+        vertexStates.reset(vertices);
+        for (int i = 1; i < buses.size(); i++) {
+            buses[i].reset();
+        }
+        for (int i = 1; i < busesOriginResult.size(); i++) {
+            vector<Point> &result = busesOriginResult[i];
+            for (const Point &point: result) {
+                //只需要占用通道，顶点变换能力不需要，最初没有
+                for (int j = point.startChannelId; j <= point.endChannelId; j++) {
+                    edges[point.edgeId].channel[j] = i;
+                }
+                edges[point.edgeId].addLive(i, buses[i].value, point.startChannelId,
+                                            point.endChannelId - point.startChannelId + 1);
+            }
+        }
+        searchGraph.reset();
+        for (int i = 1; i < edges.size(); i++) {
+            Edge &edge = edges[i];
+            if (!oldDie[i] && memcmp(&oldChannels[i * (CHANNEL_COUNT + 1)], edge.channel, sizeof(edge.channel)) == 0) {
+                continue;
+            }
+            //计算表
+            updateEdgeChannelTable(edge);
+        }
+
+        //计算业务占据的资源
+        remainResource = totalResource;
+        for (int i = 1; i < buses.size(); i++) {
+            Business &bus = buses[i];
+            remainResource -= calculatesResource(busesOriginResult[bus.id]);
+        }
+        remainEdgeValue = totalEdgeValue;
+        remainEdgeSize = int(edges.size()) - 1;
+    }
+
+    //获得路径经过的变通道顶点
+    inline unordered_set<int> getOriginChangeV(const Business &business, const vector<Point> &path) {
+        unordered_set<int> originChangeV;
+        if (!path.empty()) {
+            int from = business.from;
+            int lastChannel = path[0].startChannelId;
+            for (const Point &point: path) {
+                int to = edges[point.edgeId].from == from ?
+                         edges[point.edgeId].to
+                                                          : edges[point.edgeId].from;
+                if (point.startChannelId != lastChannel) {
+                    originChangeV.insert(from);
+                }
+                from = to;
+                lastChannel = point.startChannelId;
+            }
+        }
+        return originChangeV;
+    }
+
+    //获得路径经过的边
+    inline static unordered_map<int, int> getOriginEdgeIds(const vector<Point> &path) {
+        unordered_map<int, int> result;
+        if (!path.empty()) {
+            for (const Point &point: path) {
+                result[point.edgeId] = point.startChannelId;
+            }
+        }
+        return result;
+    }
+
+
+    //更新边的通道表，加快aStar搜索速度使用
+    inline static void updateEdgeChannelTable(Edge &edge) {
+        //int l1 = runtime();
+        const int *channel = edge.channel;
+        int (*freeChannelTable)[CHANNEL_COUNT + 1] = edge.freeChannelTable;
+        edge.generation = nextGeneration();
+        edge.widthChannelTable.reset();
+        for (int i = 1; i <= CHANNEL_COUNT; ++i) {
+            freeChannelTable[i][0] = 0;//长度重新置为0
+            edge.freeChannelMask[i] = Mask();
+        }
+        int freeLength = 0;
+        for (int i = 1; i <= CHANNEL_COUNT; ++i) {
+            if (channel[i] == -1) {
+                if (channel[i] == channel[i - 1]) {
+                    freeLength++;
+                } else {
+                    freeLength = 1;
+                }
+            } else {
+                freeLength = 0;
+            }
+            if (freeLength > 0) {
+                for (int j = freeLength; j > 0; --j) {
+                    const int start = i - j + 1;
+                    freeChannelTable[j][++freeChannelTable[j][0]] = start;
+                    edge.widthChannelTable.set(j * (CHANNEL_COUNT + 1) + start);
+                    edge.freeChannelMask[j].set(start);
+                }
+            }
+        }
+        //int r1 = runtime();
+        // time9 += r1 - l1;
+    }
+
+    //在老路径基础上，回收新路径
+    inline void undoBusiness(const Business &business, const vector<Point> &newPath, const vector<Point> &originPath,
+                             bool shouldUpdateEdgeTable) {
+        //变通道次数加回来
+        unordered_set<int> originChangeV = getOriginChangeV(business, originPath);
+        unordered_map<int, int> originEdgeIds = getOriginEdgeIds(originPath);
+        int from = business.from;
+        int lastChannel = newPath[0].startChannelId;
+        for (const Point &point: newPath) {
+            Edge &edge = edges[point.edgeId];
+            assert(edge.channel[point.startChannelId] == business.id);
+            int released = 0;
+            for (int j = point.startChannelId; j <= point.endChannelId; j++) {
+                if (originEdgeIds.count(point.edgeId)
+                    && j >= originEdgeIds[point.edgeId]
+                    && j <= originEdgeIds[point.edgeId]
+                            + business.needChannelLength - 1) {
+                    continue;
+                }
+                released++;
+                edge.channel[j] = -1;
+            }
+            bool changeChannel = released > 0;
+            if (changeChannel && !business.die) {
+                edge.removeLive(business.id, business.value, released);
+            }
+            if (shouldUpdateEdgeTable && changeChannel && !edge.die) {
+                updateEdgeChannelTable(edge);
+            }
+            if (useIncrementalSearch && changeChannel && !edge.die) {
+                //不马上更新通道表的，调用方搜索前会更新
+                incrementalChangedEdges.push_back(point.edgeId);
+            }
+            int to = edge.from == from ? edge.to : edge.from;
+            if (point.startChannelId != lastChannel && !originChangeV.count(from)) {
+                vertexStates.changeCounts[from]++;
+                assert(vertexStates.changeCounts[from] <= vertices[from].maxChangeCount);
+                if (useIncrementalSearch) {
+                    incrementalChangedVertices.push_back(from);
+                }
+            }
+            from = to;
+            lastChannel = point.startChannelId;
+        }
+    }
+
+    //在老路径基础上，增加新路径
+    inline void redoBusiness(const Business &business, const vector<Point> &newPath, const vector<Point> &originPath,
+                             bool shouldUpdateEdgeTable) {
+        unordered_set<int> originChangeV = getOriginChangeV(business, originPath);
+        int from = business.from;
+        int lastChannel = newPath[0].startChannelId;
+        for (const Point &point: newPath) {
+            Edge &edge = edges[point.edgeId];
+            //占用通道
+            int occupied = 0;
+            int firstChannel = 0;
+            for (int j = point.startChannelId; j <= point.endChannelId; j++) {
+                assert(edge.channel[j] == -1 || edge.channel[j] == business.id);
+                if (edge.channel[j] == -1) {
+                    if (occupied++ == 0) {
+                        firstChannel = j;
+                    }
+                    edge.channel[j] = business.id;
+                }
+                //复用啥都不干
+            }
+            bool allReuse = occupied == 0;//全部复用老路径不更新这条边，加快速度
+            if (!allReuse && !business.die) {
+                edge.addLive(business.id, business.value, firstChannel, occupied);
+            }
+            if (shouldUpdateEdgeTable && !allReuse && !edge.die) {
+                updateEdgeChannelTable(edge);
+            }
+            if (useIncrementalSearch && !allReuse && !edge.die) {
+                incrementalChangedEdges.push_back(point.edgeId);
+            }
+            int to = edge.from == from ? edge.to : edge.from;
+            if (point.startChannelId != lastChannel
+                && !originChangeV.count(from)) {//包含可以复用资源
+                //变通道，需要减
+                vertexStates.changeCounts[from]--;
+                if (useIncrementalSearch) {
+                    incrementalChangedVertices.push_back(from);
+                }
+            }
+            from = to;
+            lastChannel = point.startChannelId;
+        }
+    }
+
+    inline int getChangeChannelWeight(bool test) const {
+        return test ? searchConfig.myChangeChannelWeight : searchConfig.otherChangeChannelWeight;
+    }
+
+    //业务寻路能用的最大资源，老路径占据的资源加上分配给他的额外资源
+    inline int getMaxResource(const Business &business, const vector<Point> &originPath, int maxLength,
+                              int curLength, bool test) {
+        int originResource = calculatesResource(originPath);
+
+        //方式1,资源法，平均影响价值的算法由searchConfig选
+        int remainLength = max(min(maxLength, int(edges.size()) - 1) - curLength + 1, 1);
+        double remainNeedHelpValue;
+        if (searchConfig.needHelpValueMode == 1) {
+            // 1.当前剩余的边价值除以剩余的边，边较少效果好
+            remainNeedHelpValue = (remainEdgeValue / max(remainEdgeSize, 1.0)) * remainLength;
+        } else if (searchConfig.needHelpValueMode == 2) {
+            // 3.考虑用当前影响的边价值当作平均影响价值？
+            remainNeedHelpValue = curAffectEdgeValue * remainLength;
+        } else {
+            // 2.最开始的边价值除以全部边，边较多效果好,一般这个效果最好
+            remainNeedHelpValue = avgEdgeAffectValue * remainLength;
+        }
+        remainNeedHelpValue = max(remainNeedHelpValue, 1.0);
+
+
+        // 缩放因子，一般为0.8-1.5，因为可能死亡业务不占据资源？可以给更多资源，自己的样例和他的样例分开来
+        double factor = test ? searchConfig.mySearchResourceFactor : searchConfig.otherSearchResourceFactor;
+
+        int extraResource = (int) round(factor * (1.0 * business.value / remainNeedHelpValue) * remainResource);
+
+        //4.固定不超过1.6倍,这个中规中矩
+        //int extraResource = (int) round(max(EDGE_LENGTH_WEIGHT * business.needChannelLength * 6.0, originResource * 1.6));
+
+
+        if (maxLength == curLength) {
+            //最后一次断边，拉满资源
+            extraResource = INT_INF / 2;
+        }
+        return originResource + extraResource;
+    }
+
+    //路径在当前状态下能不能直接占用：边活着，通道空闲，变通道的顶点还有次数，不超过资源上限
+    inline bool isPathAvailable(const Business &business, const vector<Point> &path, int maxResource,
+                                int changeChannelWeight) {
+        if (path.empty() || calculatesSearchCost(path, business.needChannelLength, changeChannelWeight) > maxResource) {
+            return false;
+        }
+        thread_local vector<int> visitStamp;
+        thread_local int visitId = 0;
+        visitStamp.resize(vertices.size());
+        visitId++;
+        int from = business.from;
+        visitStamp[from] = visitId;
+        int lastChannel = path[0].startChannelId;
+        for (const Point &point: path) {
+            if (!liveChannelMask(point.edgeId, business.needChannelLength).test(point.startChannelId)) {
+                return false;
+            }
+            if (point.startChannelId != lastChannel && (from == business.from || !canChangeChannel(from))) {
+                return false;
+            }
+            const Edge &edge = edges[point.edgeId];
+            int to = edge.from == from ? edge.to : edge.from;
+            if (visitStamp[to] == visitId) {
+                return false;
+            }
+            visitStamp[to] = visitId;
+            from = to;
+            lastChannel = point.startChannelId;
+        }
+        return from == business.to;
+    }
+
+    //aStar寻路，sharedPath为共用搜索树在放宽的状态下找到的路径，当前还能用就一定最短
+    inline vector<Point>
+    aStarFindPath(Business &business, const vector<Point> &originPath, int maxLength, int curLength, bool test,
+                  bool findRedo, const vector<Point> *sharedPath = nullptr) {
+        int from = business.from;
+        int to = business.to;
+        int width = business.needChannelLength;
+        int maxResource = getMaxResource(business, originPath, maxLength, curLength, test);
+        undoBusiness(business, originPath, {}, true);
+
+        int l1 = runtime();
+        int changeChannelWeight = getChangeChannelWeight(test);
+        vector<Point> path;
+        if (sharedPath != nullptr && !sharedPath->empty()) {
+            if (isPathAvailable(business, *sharedPath, maxResource, changeChannelWeight)) {
+                sharedSearchStatistics.hits++;
+                path = *sharedPath;
+            } else {
+                sharedSearchStatistics.invalidated++;
+            }
+        }
+        //候选路径是跳数下界就一定最短，不用搜索；时间片太小时能用就用
+        if (path.empty()) {
+            path = findCandidateRoute(business, maxResource);
+            if (!path.empty()) {
+                if (int(path.size()) == minDistance[from][to]) {
+                    candidateRouteStatistics.optimalHits++;
+                } else if (useCandidateRouteOnly) {
+                    candidateRouteStatistics.fastHits++;
+                } else {
+                    path.clear();
+                }
+            }
+        }
+        if (path.empty() && !isCancelled()) {
+            if (useIncrementalSearch) {
+                path = incrementalFindPath(business.id, from, to, width, maxResource, changeChannelWeight);
+            } else {
+                path = cachedAStar(from, to, width, maxResource, changeChannelWeight);
+            }
+        }
+        int r1 = runtime();
+        searchTime += r1 - l1;
+        if (findRedo || path.empty()) {
+            redoBusiness(business, originPath, {}, true);
+        }
+        return path;
+    }
+
+    // baseLine寻路
+    inline vector<Point>
+    baseLineFindPath(Business &business) {
+        int from = business.from;
+        int to = business.to;
+        int width = business.needChannelLength;
+        int l1 = runtime();
+        vector<Point> path = SearchUtils::baseFind(from, to, width, baseSearchGraph, edges);
+        int r1 = runtime();
+        searchTime += r1 - l1;
+        return path;
+    }
+
+    inline vector<Point>
+    baseLineFindPath2(Business &business, const vector<Point> &originPath) {
+        int from = business.from;
+        int to = business.to;
+        int width = business.needChannelLength;
+        int l1 = runtime();
+        undoBusiness(business, originPath, {}, true);
+        vector<Point> path = SearchUtils::baseFind(from, to, width, baseSearchGraph, edges);
+        redoBusiness(business, originPath, {}, true);
+        int r1 = runtime();
+        searchTime += r1 - l1;
+        return path;
+    }
+
+    //把全部增加上的新路径回收掉
+    void undoResult(const unordered_map<int, vector<Point>> &result, const vector<vector<Point>> &curBusesResult,
+                    int tmpRemainResource, bool onlySearchOne) {
+        unordered_set<int> updateEdgesId;//一起更新
+        for (const auto &entry: result) {
+            int id = entry.first;
+            const vector<Point> &newPath = entry.second;
+            Business &business = buses[id];
+            const vector<Point> &originPath = curBusesResult[business.id];
+            if (!onlySearchOne) {
+                undoBusiness(business, newPath, originPath, false);
+                for (const auto &item: newPath) {
+                    if (!edges[item.edgeId].die) {
+                        updateEdgesId.insert(item.edgeId);
+                    }
+                }
+            }
+        }
+        for (const auto &id: updateEdgesId) {
+            updateEdgeChannelTable(edges[id]);
+        }
+        remainResource = tmpRemainResource;
+    }
+
+
+    //把全部需要增加上的新路径增加进去，并且回收老路径
+    void redoResult(vector<int> &affectBusinesses, unordered_map<int, vector<Point>> &result,
+                    vector<vector<Point>> &curBusesResult, bool onlySearchOne) {
+        remainEdgeSize--;
+        unordered_set<int> updateEdgesId;//一起更新
+        for (const auto &entry: result) {
+            int id = entry.first;
+            const vector<Point> &newPath = entry.second;
+            const vector<Point> &originPath = curBusesResult[id];
+            const Business &business = buses[id];
+            //先加入新路径
+            if (!onlySearchOne) {
+                redoBusiness(business, newPath, originPath, false);
+                for (const auto &item: newPath) {
+                    if (!edges[item.edgeId].die) {
+                        updateEdgesId.insert(item.edgeId);
+                    }
+                }
+            }
+            //未错误，误报
+            undoBusiness(business, originPath, newPath, false);
+            for (const auto &item: originPath) {
+                if (!edges[item.edgeId].die) {
+                    updateEdgesId.insert(item.edgeId);
+                }
+            }
+
+            remainEdgeValue -= int(originPath.size()) * business.value;
+            remainEdgeValue += int(newPath.size()) * business.value;
+            remainResource += calculatesResource(originPath);
+            //断边上的资源无法回收
+            remainResource -= business.needChannelLength * EDGE_LENGTH_WEIGHT;
+            remainResource -= calculatesResource(newPath);
+            curBusesResult[business.id] = newPath;
+        }
+        for (const auto &id: updateEdgesId) {
+            updateEdgeChannelTable(edges[id]);
+        }
+        for (const int &id: affectBusinesses) {
+            Business &business = buses[id];
+            if (!result.count(business.id)) {
+                remainEdgeValue -= int(curBusesResult[id].size()) * business.value;
+                business.die = true;//死掉了，以后不调度
+                for (const Point &point: curBusesResult[id]) {
+                    edges[point.edgeId].killLive(id, business.value);
+                }
+            }
+        }
+    }
+
+    //给路径打分，随机穷举使用
+    inline double getEstimateScore(const unordered_map<int, vector<Point>> &satisfyBusesResult) {
+        int totalValue = 0;
+        for (const auto &entry: satisfyBusesResult) {
+            totalValue += buses[entry.first].value;
+        }
+        //原则，value，width大的尽量短一点
+        double plus = 0;
+        for (const auto &entry: satisfyBusesResult) {
+            int id = entry.first;
+            const vector<Point> &newPath = entry.second;
+            const Business &business = buses[id];
+            int size = int(newPath.size());
+            //int width = business.needChannelLength;
+            int value = business.value;//价值高，size小好，width暂时不用吧
+            plus += 1.0 * value / size;
+        }
+        return totalValue * 1e9 + plus + 1;
+    }
+
+
+    //全部业务都救回来而且都是最短路，重排不可能更好
+    inline bool isPerfectResult(const unordered_map<int, vector<Point>> &result, int affectSize) {
+        if (int(result.size()) < affectSize) {
+            return false;
+        }
+        for (const auto &entry: result) {
+            const Business &business = buses[entry.first];
+            if (int(entry.second.size()) > minDistance[business.from][business.to]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //起点和宽度相同的业务共用一棵搜索树，搜索时组内业务的老路径都先回收，是放宽的状态，
+    //按优先级提交时路径还能用就一定最短，否则单独重新搜索
+    unordered_map<int, vector<Point>>
+    getSharedSearchPaths(const vector<int> &affectBusinesses, const vector<vector<Point>> &curBusesResult,
+                         int maxLength, int curLength, bool test) {
+        unordered_map<int, vector<Point>> result;
+        map<pair<int, int>, vector<int>> groups;
+        for (int id: affectBusinesses) {
+            groups[{buses[id].from, buses[id].needChannelLength}].push_back(id);
+        }
+        int changeChannelWeight = getChangeChannelWeight(test);
+        for (const auto &entry: groups) {
+            const vector<int> &ids = entry.second;
+            if (isCancelled()) {
+                break;
+            }
+            if (ids.size() < SHARED_SEARCH_MIN_GROUP_SIZE) {
+                continue;
+            }
+            sharedSearchStatistics.groups++;
+            sharedSearchStatistics.members += int(ids.size());
+            int maxResource = 0;
+            vector<int> ends;
+            for (int id: ids) {
+                maxResource = max(maxResource, getMaxResource(buses[id], curBusesResult[id], maxLength, curLength,
+                                                              test));
+                ends.push_back(buses[id].to);
+            }
+            for (int id: ids) {
+                undoBusiness(buses[id], curBusesResult[id], {}, true);
+            }
+            int l1 = runtime();
+            vector<vector<Point>> paths = SearchUtils::aStarMulti(entry.first.first, ends, entry.first.second,
+                                                                  searchGraph, edges, vertexStates, minDistance,
+                                                                  maxResource, changeChannelWeight, &searchDeadline);
+            searchTime += runtime() - l1;
+            for (int id: ids) {
+                redoBusiness(buses[id], curBusesResult[id], {}, true);
+            }
+            for (int k = 0; k < ids.size(); k++) {
+                if (!paths[k].empty()) {
+                    result[ids[k]] = std::move(paths[k]);
+                }
+            }
+        }
+        return result;
+    }
+
+//简单获得一个基础分
+    inline unordered_map<int, vector<Point>>
+    getBaseLineResult(const vector<int> &affectBusinesses, vector<vector<Point>> &curBusesResult,
+                      int maxLength, int curLength, bool base, bool test) {
+        unordered_map<int, vector<Point>> satisfyBusesResult;
+        unordered_map<int, vector<Point>> sharedPaths;
+        if (!base && USE_SHARED_SEARCH) {
+            sharedPaths = getSharedSearchPaths(affectBusinesses, curBusesResult, maxLength, curLength, test);
+        }
+        for (int id: affectBusinesses) {
+            if (isCancelled()) {
+                break;
+            }
+            Business &business = buses[id];
+            vector<Point> path;
+            vector<Point> &originPath = curBusesResult[business.id];
+            if (base) {
+                path = baseLineFindPath(business);
+            } else {
+                auto it = sharedPaths.find(id);
+                path = aStarFindPath(business, originPath, maxLength, curLength, test, false,
+                                     it == sharedPaths.end() ? nullptr : &it->second);
+            }
+            if (!path.empty()) {
+                //变通道次数得减回去
+                unordered_set<int> updateEdgesId;//一起更新
+                if (!base) {
+                    //没有redo，要自己redo
+                    redoBusiness(business, originPath, {}, false);
+                    for (const auto &item: originPath) {
+                        if (!edges[item.edgeId].die) {
+                            updateEdgesId.insert(item.edgeId);
+                        }
+                    }
+                }
+                redoBusiness(business, path, originPath, false);
+                for (const auto &item: path) {
+                    if (!edges[item.edgeId].die) {
+                        updateEdgesId.insert(item.edgeId);
+                    }
+                }
+                for (const auto &edgeId: updateEdgesId) {
+                    updateEdgeChannelTable(edges[edgeId]);
+                }
+                satisfyBusesResult[business.id] = std::move(path);
+            }
+        }
+        return satisfyBusesResult;
+    }
+
+    //核心调度函数
+    inline void
+    dispatch(vector<vector<Point>> &curBusesResult, int failEdgeId, int maxLength, int curLength, bool base,
+             bool test) {
+        assert(failEdgeId != 0);
+        edges[failEdgeId].die = true;
+        edges[failEdgeId].generation = nextGeneration();
+        if (!test) {
+            curHandleCount++;
+        }
+        for (int i = 1; i <= CHANNEL_COUNT; i++) {
+            //额外减少的资源
+            if (edges[failEdgeId].channel[i] == -1) {
+                remainResource -= EDGE_LENGTH_WEIGHT;
+            }
+        }
+
+        //1.求受影响的业务
+        vector<int> affectBusinesses = getAllUnDieBusinessId(failEdgeId);
+        curAffectEdgeValue = edges[failEdgeId].liveValue;
+
+        if (base) {
+            sort(affectBusinesses.begin(), affectBusinesses.end(), [&](int aId, int bId) {
+                return aId < bId;
+            });
+            sort(affectBusinesses.begin(), affectBusinesses.end(), [&](int aId, int bId) {
+                return buses[aId].value > buses[bId].value;
+            });
+        } else {
+            //跟java一致，使用稳定排序
+            stable_sort(affectBusinesses.begin(), affectBusinesses.end(), [&](int aId, int bId) {
+                return buses[aId].value > buses[bId].value;
+            });
+        }
+        int affectSize = int(affectBusinesses.size());
+
+
+        //3.循环调度,求出最优解保存
+        unordered_map<int, vector<Point>> bestResult;
+        double bestScore = -1;
+        int remainTime = (int) (SEARCH_TIME - 1500 - int(runtime()));//留1s阈值
+        int remainMaxCount = max(1, MAX_E_FAIL_COUNT - curHandleCount + 1);
+        if (!test && timeBudget.remainEventCount > 0) {
+            remainMaxCount = timeBudget.remainEventCount;
+        }
+        int maxRunTime = remainTime / remainMaxCount;
+        if (!test && !base) {
+            //按受影响价值和业务数加权，跟平均权重比，难的多给时间，没用完的自动留给后面
+            double weight = curAffectEdgeValue * sqrt(1.0 * affectSize);
+            timeBudget.weightSum += weight;
+            timeBudget.eventCount++;
+            double avgWeight = timeBudget.weightSum / timeBudget.eventCount;
+            double factor = avgWeight > 0 ? min(TIME_BUDGET_MAX_FACTOR, weight / avgWeight) : 1.0;
+            maxRunTime = (int) (maxRunTime * factor);
+        }
+        useCandidateRouteOnly = !test && !base && 1.0 * remainTime / remainMaxCount < CANDIDATE_ROUTE_FAST_TIME_SLICE;
+        heuristicWeight = !test && !base && 1.0 * remainTime / remainMaxCount < FOCAL_SEARCH_TIME_SLICE
+                          ? FOCAL_HEURISTIC_WEIGHT : HEURISTIC_WEIGHT_EXACT;
+        //重放时和时间有关的决定都照记录的来
+        const DispatchDecision *forced = forcedDecision;
+        if (forced != nullptr) {
+            useCandidateRouteOnly = forced->candidateRouteOnly;
+            heuristicWeight = forced->heuristicWeight;
+        }
+        DispatchDecision decision;
+        decision.heuristicWeight = heuristicWeight;
+        decision.candidateRouteOnly = useCandidateRouteOnly;
+        int tmpRemainResource = remainResource;
+        int startTime = runtime();
+        int iteration = 0;
+        //会多次重排的时候，每个业务保留搜索树，后面的重排只修复
+        clearIncrementalTrees();
+        useIncrementalSearch = incrementalSearchEnabled && IS_ONLINE && !test && !base
+                               && affectSize >= INCREMENTAL_SEARCH_MIN_BUSINESS;
+        //第一次必须有完整的解，只受整体时间限制，后面的重排超过时间片就中断
+        searchDeadline.expired = false;
+        searchDeadline.clock = &clock;
+        searchDeadline.endTime = IS_ONLINE && !test && forced == nullptr ? SEARCH_TIME - SEARCH_SAFE_TIME : INT_INF;
+        bool repeat = false;
+        while (iteration == 0 || repeat) {
+            int l1 = runtime();
+            unordered_map<int, vector<Point>> satisfyBusesResult = getBaseLineResult(affectBusinesses,
+                                                                                     curBusesResult,
+                                                                                     maxLength, curLength, base, test
+            );
+
+
+            //2.算分，被中断的重排结果不完整，不要
+            bool interrupted = searchDeadline.expired
+                               || (forced != nullptr && forced->lastPassInterrupted && iteration == forced->passes - 1);
+            if (interrupted) {
+                deadlineStatistics.interruptedPasses++;
+            }
+            decision.lastPassInterrupted = interrupted;
+            double curScore_ = interrupted && iteration > 0 ? -1 : getEstimateScore(satisfyBusesResult);
+            if (curScore_ > bestScore) {
+                //打分
+                bestScore = curScore_;
+                bestResult = satisfyBusesResult;
+            }
+
+            //3.重排,穷举
+            undoResult(satisfyBusesResult, curBusesResult, tmpRemainResource, !IS_ONLINE || test);//回收结果，下次迭代
+            if (iteration == 0 && forced == nullptr) {
+                searchDeadline.endTime = min(searchDeadline.endTime, startTime + maxRunTime);
+            }
+            iteration++;
+            int r1 = runtime();
+
+            //是否重复判断，全部救回来而且都是最短路就没必要再排了
+            bool again = forced != nullptr ? iteration < forced->passes
+                                           : IS_ONLINE && !test && maxRunTime - (r1 - startTime) - (r1 - l1) > 0
+                                             && !isCancelled() && !isPerfectResult(bestResult, affectSize);
+            if (again) {
+                searchGraph.shuffle(searchRad);
+                shuffle(affectBusinesses.begin(), affectBusinesses.end(), searchRad);
+                repeat = true;
+            } else {
+                repeat = false;
+            }
+            //printError("iteration:" + to_string(iteration) + ",curHandleCount:" + to_string(curHandleCount));
+        }
+        searchDeadline.endTime = INT_INF;
+        searchDeadline.expired = false;
+        useIncrementalSearch = false;
+        useCandidateRouteOnly = false;
+        heuristicWeight = HEURISTIC_WEIGHT_EXACT;
+        clearIncrementalTrees();
+        redoResult(affectBusinesses, bestResult, curBusesResult, !IS_ONLINE || test);
+        lastDispatchResult.swap(bestResult);
+        decision.passes = iteration;
+        lastDecision = decision;
+
+    }
+
+    inline int calculatesResource(const vector<Point> &path) const {
+        //计算通道资源
+        int channelResource = 0;
+        int changChannelResource = 0;
+        for (int i = 0; i < path.size(); i++) {
+            channelResource += EDGE_LENGTH_WEIGHT * (path[i].endChannelId - path[i].startChannelId + 1);
+            if (i >= 1 && path[i - 1].startChannelId != path[i].startChannelId) {
+                changChannelResource += resourceChangeChannelWeight;
+            }
+        }
+        return channelResource + changChannelResource;
+    }
+
+    //一个探测场景的模拟结果
+    struct CapabilityProbe {
+        vector<int> sample;//断边序列
+        int lostValue;//跑完以后死掉的业务价值
+        vector<int> peakUsage;//每个顶点每条断边调度完以后用掉的变通道次数的最大值
+        vector<char> touched;//受影响的业务最后的路径经过的顶点，死掉的按原路径
+    };
+
+    struct CapabilityStatistics {
+        long long moves;//试过的移动
+        long long accepted;//接受的移动
+        long long skipped;//没有探测场景依赖这两个顶点，不用模拟直接拒绝
+        long long simulations;//跑过的探测场景次数
+        int initialLost;
+        int finalLost;
+    };
+
+    CapabilityStatistics capabilityStatistics{};
+
+    //在s上从初始状态跑一遍探测场景，跑完状态恢复
+    void simulateProbe(Strategy &s, CapabilityProbe &probe) {
+        vector<vector<Point>> curBusesResult = busesOriginResult;
+        probe.peakUsage.assign(N + 1, 0);
+        probe.touched.assign(N + 1, false);
+        vector<int> affectIds;
+        for (int j = 0; j < probe.sample.size(); j++) {
+            int failEdgeId = probe.sample[j];
+            vector<int> beforeIds = s.getAllUnDieBusinessId(failEdgeId);
+            affectIds.insert(affectIds.end(), beforeIds.begin(), beforeIds.end());
+            s.dispatch(curBusesResult, failEdgeId, int(probe.sample.size()), j + 1, false, true);
+            for (int v = 1; v <= N; v++) {
+                probe.peakUsage[v] = max(probe.peakUsage[v],
+                                         s.vertices[v].maxChangeCount - s.vertexStates.changeCounts[v]);
+            }
+        }
+        probe.lostValue = 0;
+        for (int i = 1; i < s.buses.size(); i++) {
+            if (s.buses[i].die) {
+                probe.lostValue += s.buses[i].value;
+            }
+        }
+        for (int busId: affectIds) {
+            const vector<Point> &path = s.buses[busId].die ? busesOriginResult[busId] : curBusesResult[busId];
+            for (const Point &point: path) {
+                probe.touched[edges[point.edgeId].from] = true;
+                probe.touched[edges[point.edgeId].to] = true;
+            }
+        }
+        s.reset();
+    }
+
+    //探测场景在线程池上并行模拟，过了截止时间没跑完的返回false
+    bool simulateProbes(vector<CapabilityProbe> &probes, const vector<int> &indexes, int endTime) {
+        prepareWorkerClones();
+        vector<char> finished = getPool().run(int(indexes.size()), [&](int worker, int index) {
+            simulateProbe(getWorkerStrategy(worker), probes[indexes[index]]);
+        }, &clock, endTime);
+        capabilityStatistics.simulations += indexes.size();
+        for (char f: finished) {
+            if (!f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //从热力图分配出发，每次从一个顶点挪一个变通道能力给另一个顶点，只重跑依赖这两个顶点的探测场景，
+    //死掉的价值变少才接受。寻路只看剩余次数是不是大于0，减的顶点没用满、加的顶点没用满或者没有受影响业务经过，
+    //这个场景的结果都不变
+    void optimizeChangeCounts() {
+        int endTime = runtime() + CAPABILITY_SEARCH_TIME;
+        default_random_engine capabilityRad{CAPABILITY_RANDOM_SEED};
+        vector<int> carryEdges;
+        for (int i = 1; i < edges.size(); i++) {
+            if (!getAllUnDieBusinessId(i).empty()) {
+                carryEdges.push_back(i);
+            }
+        }
+        if (carryEdges.empty()) {
+            return;
+        }
+        vector<CapabilityProbe> probes(CAPABILITY_PROBE_COUNT);
+        vector<int> allIndexes;
+        for (int k = 0; k < probes.size(); k++) {
+            shuffle(carryEdges.begin(), carryEdges.end(), capabilityRad);
+            probes[k].sample.assign(carryEdges.begin(), carryEdges.begin()
+                                                         + min(CAPABILITY_PROBE_LENGTH, int(carryEdges.size())));
+            allIndexes.push_back(k);
+        }
+        if (!simulateProbes(probes, allIndexes, endTime)) {
+            return;
+        }
+        int lostValue = 0;
+        for (const CapabilityProbe &probe: probes) {
+            lostValue += probe.lostValue;
+        }
+        capabilityStatistics.initialLost = lostValue;
+
+        vector<CapabilityProbe> candidates(CAPABILITY_PROBE_COUNT);
+        while (runtime() < endTime && lostValue > 0) {
+            //加的顶点从用满而且有受影响业务经过的里面挑，减的顶点随机挑两个，取用满的场景少的
+            vector<int> receivers;
+            for (int v = 1; v <= N; v++) {
+                if (vertices[v].maxChangeCount >= MAX_VERTEX_CHANGE_COUNT) {
+                    continue;
+                }
+                for (const CapabilityProbe &probe: probes) {
+                    if (probe.touched[v] && probe.peakUsage[v] >= vertices[v].maxChangeCount) {
+                        receivers.push_back(v);
+                        break;
+                    }
+                }
+            }
+            if (receivers.empty()) {
+                break;
+            }
+            int to = receivers[capabilityRad() % receivers.size()];
+            int from = -1;
+            int fromUsage = INT_INF;
+            for (int t = 0; t < 2; t++) {
+                int v = int(1 + capabilityRad() % N);
+                if (v == to || vertices[v].maxChangeCount == 0) {
+                    continue;
+                }
+                int usage = 0;
+                for (const CapabilityProbe &probe: probes) {
+                    usage += probe.peakUsage[v] >= vertices[v].maxChangeCount;
+                }
+                if (usage < fromUsage) {
+                    from = v;
+                    fromUsage = usage;
+                }
+            }
+            if (from == -1) {
+                continue;
+            }
+            capabilityStatistics.moves++;
+            vector<int> indexes;
+            for (int k = 0; k < probes.size(); k++) {
+                const CapabilityProbe &probe = probes[k];
+                if (probe.peakUsage[from] >= vertices[from].maxChangeCount
+                    || (probe.touched[to] && probe.peakUsage[to] >= vertices[to].maxChangeCount)) {
+                    indexes.push_back(k);
+                }
+            }
+            //加的顶点在哪个场景里都用不上，这个移动只会不变或者变差，不用跑
+            bool receiverUsed = false;
+            for (int k: indexes) {
+                receiverUsed |= probes[k].touched[to] && probes[k].peakUsage[to] >= vertices[to].maxChangeCount;
+            }
+            if (!receiverUsed) {
+                capabilityStatistics.skipped++;
+                continue;
+            }
+            vertices[from].maxChangeCount--;
+            vertexStates.changeCounts[from]--;
+            vertices[to].maxChangeCount++;
+            vertexStates.changeCounts[to]++;
+            for (int k: indexes) {
+                candidates[k].sample = probes[k].sample;
+            }
+            bool finished = simulateProbes(candidates, indexes, endTime);
+            int newLostValue = lostValue;
+            for (int k: indexes) {
+                newLostValue += candidates[k].lostValue - probes[k].lostValue;
+            }
+            if (finished && newLostValue < lostValue) {
+                capabilityStatistics.accepted++;
+                lostValue = newLostValue;
+                for (int k: indexes) {
+                    swap(probes[k], candidates[k]);
+                }
+            } else {
+                vertices[from].maxChangeCount++;
+                vertexStates.changeCounts[from]++;
+                vertices[to].maxChangeCount--;
+                vertexStates.changeCounts[to]--;
+            }
+        }
+        capabilityStatistics.finalLost = lostValue;
+    }
+
+//初始化
+    void init(const NetworkInput &input) override {
+        N = input.vertexCount;
+        M = int(input.edges.size());
+        edges.resize(M + 1);
+        vertices.resize(N + 1);
+        minDistance.resize(N + 1);
+        createScores.assign(M + 1, 0);
+        baseRepValue.assign(M + 1, {});
+        meRepValue.assign(M + 1, {});
+        baseOriginValue.assign(M + 1, {});
+        for (int i = 1; i <= N; i++) {
+            vertices[i].maxChangeCount = input.changeCounts[i - 1];
+        }
+        vertexStates.reset(vertices);
+        graph.resize(N + 1);
+        for (int i = 1; i <= M; i++) {
+            int ui = input.edges[i - 1].from, vi = input.edges[i - 1].to;
+            edges[i].from = ui;
+            edges[i].to = vi;
+            graph[ui].push_back({i, vi});
+            graph[vi].push_back({i, ui});
+        }
+
+
+        int J = int(input.businesses.size());
+        buses.resize(J + 1);
+        busesOriginResult.resize(J + 1);
+        for (int i = 1; i <= J; i++) {
+            const NetworkBusiness &item = input.businesses[i - 1];
+            buses[i].id = i;
+            buses[i].from = item.from;
+            buses[i].to = item.to;
+            buses[i].needChannelLength = item.endChannel - item.startChannel + 1;
+            buses[i].value = item.value;
+            for (int edgeId: item.edgeIds) {
+                busesOriginResult[i].push_back({edgeId, item.startChannel, item.endChannel});
+            }
+            redoBusiness(buses[i], busesOriginResult[i], {}, false);//防止复赛修改为初始业务也能变通道
+        }
+        //调整变通道权重，预计算的打分要用，先算好再算输入哈希
+        int totalChangeCount = 0;
+        int ownCount = 0;
+        for (int i = 1; i < vertices.size(); i++) {
+            Vertex &vertex = vertices[i];
+            totalChangeCount += vertex.maxChangeCount;
+            if (vertex.maxChangeCount > 0) {
+                ownCount++;
+            }
+        }
+        //1考虑拥有能力个数，和总共个数去调整
+        //我的样例，和他的样例可能weight不太一样，最好一样？
+        //我的样例变通道权重，也用来计算资源；他的样例变通道权重，只是寻路用
+        int myChangeChannelWeight = max(1, EDGE_LENGTH_WEIGHT * (int(vertices.size()) - 1) / ownCount);
+        int otherChangeChannelWeight = max(1, EDGE_LENGTH_WEIGHT * (int(vertices.size()) - 1) / ownCount / 2);
+        resourceChangeChannelWeight = myChangeChannelWeight;
+        searchConfig = {myChangeChannelWeight, otherChangeChannelWeight, MY_SAMPLE_SEARCH_RESOURCE_FACTOR,
+                        OTHER_SAMPLE_SEARCH_RESOURCE_FACTOR, 0};
+        //2只考虑总共个数,效果很差
+//        myChangeChannelWeight = EDGE_LENGTH_WEIGHT * (int(edges.size()) - 1) * 1 / totalChangeCount;
+//        otherChangeChannelWeight = EDGE_LENGTH_WEIGHT * (int(edges.size()) - 1) * 1 / totalChangeCount;
+
+        computeInputHash();
+        PrecomputeCache cache;
+        //重放不做变通道能力搜索，结果和正常跑的不一样，缓存不读也不写
+        bool cached = !replaying && loadPrecomputeCache(cache);
+
+
+        searchGraph.build(graph);
+        baseSearchGraph.build(graph);
+        if (cached) {
+            for (int start = 1; start <= N; ++start) {
+                for (int i = 1; i <= N; ++i) {
+                    minDistance[start][i] = cache.minDistance[(start - 1) * N + i - 1];
+                }
+            }
+        } else {
+            SearchUtils::hopDistances(searchGraph, edges, minDistance, getPool());
+        }
+
+        //更新快速跳表
+        for (int i = 1; i < edges.size(); i++) {
+            Edge &edge = edges[i];
+            //计算表
+            updateEdgeChannelTable(edge);
+        }
+        buildCandidateRoutes();
+
+        //todo 调整变通道能力
+
+
+        //计算整体资源,通道资源，加变通道资源
+        for (int i = 1; i < edges.size(); i++) {
+            totalResource += CHANNEL_COUNT * EDGE_LENGTH_WEIGHT;
+        }
+        for (int i = 1; i < vertices.size(); i++) {
+            Vertex &vertex = vertices[i];
+            totalResource += resourceChangeChannelWeight * vertex.maxChangeCount;
+        }
+
+        remainResource = totalResource;
+        for (int i = 1; i < buses.size(); i++) {
+            Business &bus = buses[i];
+            remainResource -= calculatesResource(busesOriginResult[bus.id]);
+        }
+        for (int i = 1; i < edges.size(); i++) {
+            totalEdgeValue += edges[i].liveValue;
+        }
+        remainEdgeValue = totalEdgeValue;
+        remainEdgeSize = int(edges.size()) - 1;
+        avgEdgeAffectValue = 1.0 * totalEdgeValue / (int(edges.size()) - 1);
+
+        // ========================================
+        /* 变通道能力权重分配 */
+        if (cached) {
+            for (int i = 1; i <= N; i++) {
+                vertices[i].hotWeight = cache.hotWeight[i - 1];
+                vertices[i].maxChangeCount = cache.maxChangeCount[i - 1];
+                vertexStates.changeCounts[i] = vertices[i].maxChangeCount;
+            }
+            for (int i = 1; i <= M; i++) {
+                createScores[i] = cache.createScores[i - 1];
+                vector<vector<int>> *lists[3] = {&baseRepValue[i], &meRepValue[i], &baseOriginValue[i]};
+                for (int k = 0; k < 3; k++) {
+                    const vector<int> &list = cache.valueLists[k][i - 1];
+                    for (int j = 0; j < list.size(); j += 2) {
+                        lists[k]->push_back({list[j], list[j + 1]});
+                    }
+                }
+            }
+            return;
+        }
+        // 方法二：根据最短路径的热力图，进行权重分配
+        for (int i = 1; i <= J; i++) {
+            Business &business = buses[i];
+            const vector<Point> &originPath = busesOriginResult[i];
+            vector<Point> meFindPath = aStarFindPath(
+                    business, originPath,
+                    EVERY_SCENE_MAX_FAIL_EDGE_COUNT, 1,
+                    true, true
+            );
+            if (meFindPath.empty()) {
+                // printError("find path failed");
+                continue;
+            }
+            int cur = buses[i].from;
+            for (auto &e: meFindPath) {
+                cur = edges[e.edgeId].from == cur ? edges[e.edgeId].to : edges[e.edgeId].from;
+                vertices[cur].hotWeight++;
+            }
+            // assert(cur==buses[i].to);
+            vertices[buses[i].to].hotWeight--;
+        }
+        // 方法三：根据邻接表的热力图，进行权重分配
+        int initTotalChangeCount = 0;
+        int initTotalHotWeight = 0;
+        for (int i = 1; i <= N; i++) {
+            initTotalChangeCount += vertices[i].maxChangeCount;
+            initTotalHotWeight += vertices[i].hotWeight;
+            vertices[i].maxChangeCount = 0;
+        }
+        while (true) {
+            int totalDelta = 0;
+            for (int i = 1; i <= N; i++) {
+                int delta = min(MAX_VERTEX_CHANGE_COUNT - vertices[i].maxChangeCount,
+                                int(1.0 * initTotalChangeCount * vertices[i].hotWeight / initTotalHotWeight));
+                vertices[i].maxChangeCount += delta;
+                totalDelta += delta;
+            }
+            initTotalChangeCount -= totalDelta;
+            // 只第一次按照权重
+            break;
+            // 一直按照权重分，直到分不了
+            // if(initTotalChangeCount <= 0 || totalDelta <= 0) break;
+        }
+        vector<int> idxs(N);
+        for (int i = 0; i < N; i++) idxs[i] = i + 1;
+        sort(idxs.begin(), idxs.end(), [&](const int &a, const int &b) {
+            return vertices[a].hotWeight > vertices[b].hotWeight;
+        });
+        while (true) {
+            for (int i: idxs) {
+                if (initTotalChangeCount <= 0) break;
+                if (vertices[i].maxChangeCount >= MAX_VERTEX_CHANGE_COUNT) continue;
+                vertices[i].maxChangeCount++;
+                initTotalChangeCount--;
+            }
+            if (initTotalChangeCount <= 0) break;
+        }
+        // 更新剩余变通道次数
+        for (int i = 1; i <= N; i++) {
+            vertexStates.changeCounts[i] = vertices[i].maxChangeCount;
+        }
+        // 方法四：探测场景上模拟，局部搜索调整
+        if (useCapabilitySearch && !replaying) {
+            optimizeChangeCounts();
+        }
+        // ========================================
+
+
+        //每个通道变现的价值，每条边一个任务，在各自线程的克隆上断边，结果写回主对象
+        prepareWorkerClones();
+        getPool().run(int(edges.size()) - 1, [this](int worker, int index) {
+            createEdgeScore(getWorkerStrategy(worker), index + 1);
+        });
+        curAffectEdgeValue = 0;
+        if (!replaying) {
+            savePrecomputeCache();
+        }
+
+    }
+
+    //预计算缓存，init里和输入有关的最慢的几步：最短跳数、变通道能力分配、每条边的打分和影响列表
+    struct PrecomputeCache {
+        vector<int> minDistance;//N*N
+        vector<int> hotWeight;
+        vector<int> maxChangeCount;//分配以后的变通道能力
+        vector<int> createScores;
+        vector<vector<int>> valueLists[3];//baseRepValue,meRepValue,baseOriginValue，每条边(边,价值)展开
+    };
+
+    unsigned long long inputHash = 0;//图、业务、变通道能力，以及影响分配结果的搜索设置的哈希
+
+    void computeInputHash() {
+        unsigned long long hash = 14695981039346656037ULL;
+        fnvHash(hash, CHANNEL_COUNT);
+        fnvHash(hash, EDGE_LENGTH_WEIGHT);
+        fnvHash(hash, N);
+        fnvHash(hash, M);
+        for (int i = 1; i <= N; i++) {
+            fnvHash(hash, vertices[i].maxChangeCount);
+        }
+        for (int i = 1; i <= M; i++) {
+            fnvHash(hash, edges[i].from);
+            fnvHash(hash, edges[i].to);
+        }
+        fnvHash(hash, int(buses.size()) - 1);
+        for (int i = 1; i < buses.size(); i++) {
+            const Business &business = buses[i];
+            fnvHash(hash, business.from);
+            fnvHash(hash, business.to);
+            fnvHash(hash, business.needChannelLength);
+            fnvHash(hash, business.value);
+            fnvHash(hash, int(busesOriginResult[i].size()));
+            for (const Point &point: busesOriginResult[i]) {
+                fnvHash(hash, point.edgeId);
+                fnvHash(hash, point.startChannelId);
+            }
+        }
+        //变通道能力局部搜索的结果和开关、实际能用的时间(时间压缩以后的毫秒数)、线程数都有关
+        fnvHash(hash, useCapabilitySearch);
+        if (useCapabilitySearch) {
+            fnvHash(hash, int(CAPABILITY_SEARCH_TIME / clock.scale));
+            fnvHash(hash, CAPABILITY_PROBE_COUNT);
+            fnvHash(hash, CAPABILITY_PROBE_LENGTH);
+            fnvHash(hash, CAPABILITY_RANDOM_SEED);
+            fnvHash(hash, getPool().size());
+        }
+        //打分和影响列表按我的样例的寻路参数算，默认参数改了也要换缓存
+        fnvHash(hash, searchConfig.myChangeChannelWeight);
+        fnvHash(hash, searchConfig.otherChangeChannelWeight);
+        fnvHash(hash, llround(searchConfig.mySearchResourceFactor * 1e6));
+        fnvHash(hash, llround(searchConfig.otherSearchResourceFactor * 1e6));
+        fnvHash(hash, searchConfig.needHelpValueMode);
+        fnvHash(hash, EVERY_SCENE_MAX_FAIL_EDGE_COUNT);
+        inputHash = hash;
+    }
+
+    string getPrecomputeCachePath() const {
+        const char *dir = getenv(PRECOMPUTE_CACHE_DIR_ENV);
+        if (dir == nullptr || dir[0] == '\0') {
+            return "";
+        }
+        char name[64];
+        snprintf(name, sizeof name, "/precompute_%016llx.bin", inputHash);
+        return string(dir) + name;
+    }
+
+    //读缓存，版本、哈希、规模、长度任何一个对不上都当成没有
+    bool loadPrecomputeCache(PrecomputeCache &cache) const {
+        string path = getPrecomputeCachePath();
+        MappedFile file;
+        if (path.empty() || !file.open(path)) {
+            return false;
+        }
+        BinaryReader reader(file.data, file.size);
+        if (reader.read<unsigned>() != PRECOMPUTE_CACHE_MAGIC || reader.read<unsigned>() != PRECOMPUTE_CACHE_VERSION
+            || reader.read<unsigned long long>() != inputHash || reader.read<int>() != N || reader.read<int>() != M
+            || reader.read<int>() != int(buses.size()) - 1 || reader.failed) {
+            return false;
+        }
+        auto readArray = [&](vector<int> &values, int count) {
+            values.resize(count);
+            for (int &value: values) {
+                value = reader.read<int>();
+            }
+        };
+        readArray(cache.minDistance, N * N);
+        readArray(cache.hotWeight, N);
+        readArray(cache.maxChangeCount, N);
+        readArray(cache.createScores, M);
+        for (vector<vector<int>> &lists: cache.valueLists) {
+            lists.resize(M);
+            for (vector<int> &list: lists) {
+                int count = reader.read<int>();
+                if (reader.failed || count < 0 || size_t(count) * 2 * sizeof(int) > file.size - reader.offset) {
+                    return false;
+                }
+                readArray(list, count * 2);
+            }
+        }
+        return !reader.failed && reader.offset == file.size;
+    }
+
+    //先写临时文件再改名，别的进程不会读到写了一半的
+    void savePrecomputeCache() const {
+        string path = getPrecomputeCachePath();
+        if (path.empty()) {
+            return;
+        }
+        //进程号加本进程的版本号，同时写同一个输入的几个进程不会用同一个临时文件
+        string tmpPath = path + ".tmp" + to_string(getpid()) + "_" + to_string(nextGeneration());
+        FILE *file = fopen(tmpPath.c_str(), "wb");
+        if (file == nullptr) {
+            return;
+        }
+        vector<char> data;
+        auto write = [&](const void *value, size_t size) {
+            data.insert(data.end(), (const char *) value, (const char *) value + size);
+        };
+        auto writeInt = [&](int value) {
+            write(&value, sizeof value);
+        };
+        write(&PRECOMPUTE_CACHE_MAGIC, sizeof PRECOMPUTE_CACHE_MAGIC);
+        write(&PRECOMPUTE_CACHE_VERSION, sizeof PRECOMPUTE_CACHE_VERSION);
+        write(&inputHash, sizeof inputHash);
+        writeInt(N);
+        writeInt(M);
+        writeInt(int(buses.size()) - 1);
+        for (int i = 1; i <= N; i++) {
+            for (int j = 1; j <= N; j++) {
+                writeInt(minDistance[i][j]);
+            }
+        }
+        for (int i = 1; i <= N; i++) {
+            writeInt(vertices[i].hotWeight);
+        }
+        for (int i = 1; i <= N; i++) {
+            writeInt(vertices[i].maxChangeCount);
+        }
+        for (int i = 1; i <= M; i++) {
+            writeInt(createScores[i]);
+        }
+        for (const vector<vector<vector<int>>> *lists: {&baseRepValue, &meRepValue, &baseOriginValue}) {
+            for (int i = 1; i <= M; i++) {
+                writeInt(int((*lists)[i].size()));
+                for (const vector<int> &pair: (*lists)[i]) {
+                    writeInt(pair[0]);
+                    writeInt(pair[1]);
+                }
+            }
+        }
+        bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+        ok = fclose(file) == 0 && ok;
+        if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+            remove(tmpPath.c_str());
+        }
+    }
+
+    //断掉一条边算打分，s是当前线程用的对象，算完状态恢复
+    void createEdgeScore(Strategy &s, int i) {
+        //每条边从空的路径缓存开始，代价相同的路径不受这个线程之前算过哪些边影响，线程数不同结果也一样
+        s.pathCache.clear();
+        vector<int> ids = s.getAllUnDieBusinessId(i);
+        s.edges[i].die = true;
+        s.edges[i].generation = nextGeneration();
+        double baseValue = 0;
+        double meValue = 0;
+        s.curAffectEdgeValue = s.edges[i].liveValue;
+        for (int id: ids) {
+            const vector<Point> &originPath = busesOriginResult[id];
+            Business &business = s.buses[id];
+            vector<Point> baseFindPath = s.baseLineFindPath(business);
+            vector<Point> meFindPath = s.aStarFindPath(business, originPath,
+                                                       EVERY_SCENE_MAX_FAIL_EDGE_COUNT, 1,
+                                                       true, true);
+            if (!baseFindPath.empty()) {
+                baseValue += buses[id].value;
+                for (Point &point: baseFindPath) {
+                    vector<int> tmp;
+                    tmp.push_back(point.edgeId);
+                    tmp.push_back(buses[id].value);
+                    baseRepValue[i].push_back(tmp);
+                }
+            } else {
+                for (const Point &point: originPath) {
+                    vector<int> tmp;
+                    tmp.push_back(point.edgeId);
+                    tmp.push_back(buses[id].value);
+                    baseOriginValue[i].push_back(tmp);
+                }
+            }
+            if (!meFindPath.empty()) {
+                meValue += buses[id].value;
+                for (Point &point: meFindPath) {
+                    vector<int> tmp;
+                    tmp.push_back(point.edgeId);
+                    tmp.push_back(buses[id].value);
+                    meRepValue[i].push_back(tmp);
+                }
+            }
+        }
+        createScores[i] = (int) round(meValue - baseValue);
+        s.edges[i].die = false;
+        s.edges[i].generation = nextGeneration();
+    }
+
+    static bool checkSatisfiedSamplesSimilarity(vector<vector<int>> &samples, vector<int> &curSample) {
+        thread_local vector<char> visit;
+        for (int item: curSample) {
+            if (item >= visit.size()) {
+                visit.resize(item + 1);
+            }
+        }
+        for (const vector<int> &sample1: samples) {
+            for (int item: sample1) {
+                if (item >= visit.size()) {
+                    visit.resize(item + 1);
+                }
+            }
+            int mergersCount = 0;
+            for (const int &item: sample1) {
+                visit[item] = true;
+                mergersCount++;
+            }
+            for (const int &item: curSample) {
+                if (!visit[item]) {
+                    mergersCount++;
+                }
+            }
+            int intersectionCount = 0;
+            for (int num: curSample) {
+                if (visit[num]) {
+                    intersectionCount++;
+                }
+            }
+            for (const int &item: sample1) {
+                visit[item] = false;
+            }
+            if (1.0 * intersectionCount / mergersCount > CREATE_SAMPLE_SIMILARITY_THRESHOLD) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    vector<int> getAllUnDieBusinessId(int failEdgeId) const {
+        const Edge &edge = edges[failEdgeId];
+        vector<int> result(edge.liveCount);
+        for (int k = 0; k < edge.liveCount; k++) {
+            result[k] = edge.lives[k].id;
+        }
+        return result;
+    }
+
+    vector<int> getBestLengthAndScore(vector<vector<int>> &otherSamples, vector<int> &sample) {
+        //最好的长度，以及分差;
+        int ourScore[sample.size()];
+        int baseScore[sample.size()];
+
+        int totalValue = 0;
+        for (int i = 1; i < buses.size(); ++i) {
+            totalValue += buses[i].value;
+        }
+        for (int i = 0; i < 2; i++) {
+            vector<vector<Point>> curBusesResult = busesOriginResult;
+            int remainValue = totalValue;
+            for (int j = 0; j < sample.size(); j++) {
+                int failEdgeId = sample[j];
+                vector<int> beforeIds = getAllUnDieBusinessId(failEdgeId);
+                dispatch(curBusesResult, failEdgeId, int(sample.size()), j + 1,
+                         i != 0, true);
+                for (int beforeId: beforeIds) {
+                    if (buses[beforeId].die) {
+                        remainValue -= buses[beforeId].value;
+                    }
+                }
+                if (i == 0) {
+                    ourScore[j] = remainValue;
+                } else {
+                    baseScore[j] = remainValue;
+                }
+            }
+            reset();
+        }
+
+        //找到分差最大的长度返回
+        vector<int> tmp = sample;
+        int maxValue = -100000000;
+        int bestLength = -1;
+        int bestMaxLength = int(sample.size());
+        for (int i = int(sample.size()) - 1; i >= 0; i--) {
+            int diff = ourScore[i] - baseScore[i];
+            if (diff > maxValue && checkSatisfiedSamplesSimilarity(otherSamples, tmp)) {
+                maxValue = diff;
+                bestLength = i;
+            }
+            tmp.pop_back();
+        }
+        if (bestLength < int(sample.size()) - 1) {
+            //重算
+            for (int i = 0; i < 1; i++) {
+                vector<vector<Point>> curBusesResult = busesOriginResult;
+                int remainValue = totalValue;
+                for (int j = 0; j < bestLength + 1; j++) {
+                    int failEdgeId = sample[j];
+                    vector<int> beforeIds = getAllUnDieBusinessId(failEdgeId);
+                    dispatch(curBusesResult, failEdgeId, bestLength + 1, j + 1, false, true);
+                    for (int beforeId: beforeIds) {
+                        if (buses[beforeId].die) {
+                            remainValue -= buses[beforeId].value;
+                        }
+                    }
+                    ourScore[j] = remainValue;
+                }
+                reset();
+            }
+            tmp = {sample.begin(), sample.begin() + bestLength + 1};
+            int curMaxLength = bestLength + 1;
+            bool find = false;
+            for (int i = bestLength; i >= 0; i--) {
+                int diff = ourScore[i] - baseScore[i];
+                if (diff > maxValue && checkSatisfiedSamplesSimilarity(otherSamples, tmp)) {
+                    maxValue = diff;
+                    bestLength = i;
+                    find = true;
+                }
+                tmp.pop_back();
+            }
+            if (find) {
+                bestMaxLength = curMaxLength;
+            }
+        }
+        vector<int> result;
+        result.push_back(bestLength + 1);
+        result.push_back(maxValue);
+        result.push_back(bestMaxLength);
+        return result;
+    }
+
+    //prefix非空时前面几条边固定用它，后面接着贪心生成，分数按前面断掉的边同样更新
+    vector<vector<int>>
+    myGenerate(vector<vector<int>> &beforeSample, int generateInitLength, int candidateEdgeSize,
+               const int sampleReturnCount, const vector<int> &prefix = {}) {
+        vector<char> beSelect(edges.size());
+        vector<vector<int>> samples;
+        vector<int> scores(edges.size());
+        generateInitLength = min(int(edges.size()) - 1, generateInitLength);
+        candidateEdgeSize = min(int(edges.size()) - 1, candidateEdgeSize);
+        struct EdgeIdScore {
+            int id;
+            int score;
+
+            bool operator<(const EdgeIdScore &o1) const {
+                return score > o1.score;
+            }
+        };
+
+        int tryCount = 0;
+        while (samples.size() < sampleReturnCount) {
+            fill(beSelect.begin(), beSelect.end(), false);
+            scores = createScores;
+            vector<int> sample;
+            for (int i = 0; i < generateInitLength; i++) {
+                int id = -1;
+                if (i < prefix.size()) {
+                    id = prefix[i];
+                } else {
+                    priority_queue<EdgeIdScore> minScoreQ;
+                    for (int j = 1; j < edges.size(); j++) {
+                        if (beSelect[j]) {
+                            continue;
+                        }
+                        if (minScoreQ.size() < candidateEdgeSize) {
+                            minScoreQ.push({j, scores[j]});
+                            continue;
+                        }
+
+                        if (scores[j] > minScoreQ.top().score) {
+                            minScoreQ.pop();
+                            minScoreQ.push({j, scores[j]});
+                        }
+                    }
+                    //随机选择一个边断掉
+                    int index = int(createSampleRad() % candidateEdgeSize);
+                    for (int j = 0; j <= index; j++) {
+                        if (minScoreQ.empty()) {
+                            break;
+                        }
+                        id = minScoreQ.top().id;
+                        minScoreQ.pop();
+                    }
+                }
+                beSelect[id] = true;
+
+                //上面路径上的分数减过去
+                vector<int> busIds = getAllUnDieBusinessId(id);
+                for (vector<int> &pa: baseRepValue[id]) {
+                    //base寻的到的+分，让他死
+                    int edId = pa[0];
+                    int addScore = pa[1];
+                    if (beSelect[edId]) {
+                        continue;
+                    }
+                    scores[edId] += addScore;
+                }
+                for (vector<int> &pa: baseOriginValue[id]) {
+                    //base寻不到的减分，让他活
+                    int edId = pa[0];
+                    int subScore = pa[1];
+                    if (beSelect[edId]) {
+                        continue;
+                    }
+                    scores[edId] -= subScore;
+                }
+                for (vector<int> &pa: meRepValue[id]) {
+                    //自己寻到的让他活
+                    int edId = pa[0];
+                    int subScore = pa[1];
+                    if (beSelect[edId]) {
+                        continue;
+                    }
+                    scores[edId] -= subScore;
+                }
+                for (vector<int> &pa: baseRepValue[id]) {
+                    //base寻的到的+分，让他死
+                    int edId = pa[0];
+                    int addScore = pa[1];
+                    if (beSelect[edId]) {
+                        continue;
+                    }
+                    scores[edId] += addScore;
+                }
+                for (vector<int> &pa: baseOriginValue[id]) {
+                    //base寻不到的减分，让他活
+                    int edId = pa[0];
+                    int subScore = pa[1];
+                    if (beSelect[edId]) {
+                        continue;
+                    }
+                    scores[edId] -= subScore;
+                }
+                for (vector<int> &pa: meRepValue[id]) {
+                    //自己寻到的让他活
+                    int edId = pa[0];
+                    int subScore = pa[1];
+                    if (beSelect[edId]) {
+                        continue;
+                    }
+                    scores[edId] -= subScore;
+                }
+
+                for (int busId: busIds) {
+                    const vector<Point> &path = busesOriginResult[busId];
+                    for (const Point &point: path) {
+                        if (beSelect[point.edgeId]) {
+                            continue;
+                        }
+                        scores[point.edgeId] -= buses[busId].value;
+                    }
+                }
+                sample.push_back(id);
+            }
+            if (checkSatisfiedSamplesSimilarity(beforeSample, sample)) {
+                samples.push_back(sample);
+            } else {
+                tryCount++;
+                if (tryCount > CREATE_SHUFFLE_MAX_TRY_COUNT) {
+                    if (generateInitLength == 1) {
+                        break;
+                    }
+                    tryCount = 0;
+                    generateInitLength = max(1, (int) (generateInitLength * 0.8));
+                }
+            }
+        }
+        return samples;
+    }
+
+    struct SampleResult {
+        int value; //价值
+        int maxLength; //价值
+        vector<int> sample;//断边序列
+        bool operator<(const SampleResult &o) const {
+            return value > o.value;
+        }
+    };
+
+    //候选序列在线程池上并行评估，按下标顺序归约，和串行结果一样；过了截止时间没评估的跳过，至少评估一个
+    //candidateScores非空时填每个候选的分差，没评估或者没有满足相似度的前缀的填-100000000
+    vector<int> getBestSample(vector<vector<int>> &beforeSamples, vector<vector<int>> &candidateSamples,
+                              int endTime = INT_INF, vector<int> *candidateScores = nullptr) {
+        int bestIndex = -1;
+        int bestLength = -1;
+        int bestScore = -1000000;
+        int bestMaxLength = -1;
+        vector<int> result;
+        vector<vector<int>> lengthAndScores(candidateSamples.size());
+        prepareWorkerClones();
+        vector<char> finished = getPool().run(int(candidateSamples.size()), [&](int worker, int index) {
+            lengthAndScores[index] = getWorkerStrategy(worker).getBestLengthAndScore(beforeSamples,
+                                                                                     candidateSamples[index]);
+        }, &clock, endTime);
+        if (!candidateSamples.empty() && !finished[0]) {
+            lengthAndScores[0] = getBestLengthAndScore(beforeSamples, candidateSamples[0]);
+            finished[0] = 1;
+        }
+        if (candidateScores != nullptr) {
+            candidateScores->assign(candidateSamples.size(), -100000000);
+            for (int i = 0; i < candidateSamples.size(); i++) {
+                if (finished[i]) {
+                    (*candidateScores)[i] = lengthAndScores[i][1];
+                }
+            }
+        }
+        for (int i = 0; i < candidateSamples.size(); i++) {
+            if (!finished[i]) {
+                continue;
+            }
+            const vector<int> &bestLengthAndScore = lengthAndScores[i];
+            if (bestLengthAndScore[1] > bestScore) {
+                bestIndex = i;
+                bestLength = bestLengthAndScore[0];
+                bestScore = bestLengthAndScore[1];
+                bestMaxLength = bestLengthAndScore[2];
+            }
+        }
+
+        result.push_back(bestIndex);
+        result.push_back(bestLength);
+        result.push_back(bestScore);
+        result.push_back(bestMaxLength);
+        return result;
+    }
+
+    SurrogateModel surrogate;
+
+    //代理模型的特征：偏置，生成打分和，影响表里前面的边断了以后后面的边的加减分，序列经过的业务价值，长度
+    void sampleFeatures(const vector<int> &sample, double *x) {
+        thread_local vector<int> position;//边在序列里的下标+1
+        thread_local vector<char> busVisit;
+        position.resize(edges.size());
+        busVisit.resize(buses.size());
+        for (int i = 0; i < sample.size(); i++) {
+            position[sample[i]] = i + 1;
+        }
+        double createScore = 0, baseRep = 0, baseOrigin = 0, meRep = 0, busValue = 0;
+        for (int i = 0; i < sample.size(); i++) {
+            int id = sample[i];
+            createScore += createScores[id];
+            for (const vector<int> &pa: baseRepValue[id]) {
+                if (position[pa[0]] > i + 1) {
+                    baseRep += pa[1];
+                }
+            }
+            for (const vector<int> &pa: baseOriginValue[id]) {
+                if (position[pa[0]] > i + 1) {
+                    baseOrigin += pa[1];
+                }
+            }
+            for (const vector<int> &pa: meRepValue[id]) {
+                if (position[pa[0]] > i + 1) {
+                    meRep += pa[1];
+                }
+            }
+            const Edge &edge = edges[id];
+            for (int k = 0; k < edge.liveCount; k++) {
+                int busId = edge.lives[k].id;
+                if (!busVisit[busId]) {
+                    busVisit[busId] = true;
+                    busValue += buses[busId].value;
+                }
+            }
+        }
+        for (int id: sample) {
+            position[id] = 0;
+            const Edge &edge = edges[id];
+            for (int k = 0; k < edge.liveCount; k++) {
+                busVisit[edge.lives[k].id] = false;
+            }
+        }
+        x[0] = 1;
+        x[1] = createScore;
+        x[2] = baseRep;
+        x[3] = baseOrigin;
+        x[4] = meRep;
+        x[5] = busValue;
+        x[6] = double(sample.size());
+    }
+
+    //候选多生成几倍，代理模型预测分差，留预测最好的keepCount个去完整模拟，模拟完的分差回来训练模型；
+    //模型见过的结果不够时不筛，直接留前面的
+    vector<int> getBestScreenedSample(vector<vector<int>> &beforeSamples, vector<vector<int>> &candidateSamples,
+                                      int keepCount, int endTime) {
+        const int F = SurrogateModel::FEATURE_COUNT;
+        vector<double> features(candidateSamples.size() * F);
+        for (int i = 0; i < candidateSamples.size(); i++) {
+            sampleFeatures(candidateSamples[i], &features[i * F]);
+        }
+        surrogate.generated += candidateSamples.size();
+        if (int(candidateSamples.size()) > keepCount && surrogate.sampleCount >= SURROGATE_MIN_TRAINING) {
+            vector<pair<double, int>> predicts;
+            for (int i = 0; i < candidateSamples.size(); i++) {
+                predicts.emplace_back(-surrogate.predict(&features[i * F]), i);
+            }
+            partial_sort(predicts.begin(), predicts.begin() + keepCount, predicts.end());
+            vector<vector<int>> keptSamples;
+            vector<double> keptFeatures;
+            for (int i = 0; i < keepCount; i++) {
+                int index = predicts[i].second;
+                keptSamples.push_back(std::move(candidateSamples[index]));
+                keptFeatures.insert(keptFeatures.end(), features.begin() + index * F,
+                                    features.begin() + (index + 1) * F);
+            }
+            candidateSamples.swap(keptSamples);
+            features.swap(keptFeatures);
+        } else if (int(candidateSamples.size()) > keepCount) {
+            candidateSamples.resize(keepCount);
+            features.resize(keepCount * F);
+        }
+        surrogate.promoted += candidateSamples.size();
+        vector<int> scores;
+        vector<int> result = getBestSample(beforeSamples, candidateSamples, endTime, &scores);
+        for (int i = 0; i < candidateSamples.size(); i++) {
+            if (scores[i] != -100000000) {
+                surrogate.add(&features[i * F], scores[i]);
+            }
+        }
+        return result;
+    }
+
+    void
+    createBaseSamples(vector<SampleResult> &results, const int candidateSampleCount, const int maxRunTime,
+                      int candidateEdgeCount,
+                      int generateInitLength) {
+        if (results.size() >= CREATE_SAMPLE_COUNT) {
+            return;
+        }
+
+        vector<vector<int>> curSamples;
+        for (const SampleResult &result: results) {
+            curSamples.push_back(result.sample);
+        }
+        candidateEdgeCount = min(candidateEdgeCount, int(edges.size()) - 1);
+        generateInitLength = min(generateInitLength, int(edges.size()) - 1);
+
+        int oneMaxRunTime = (int) (maxRunTime - runtime()) / (CREATE_SAMPLE_COUNT - int(results.size()));
+        while (results.size() < CREATE_SAMPLE_COUNT) {
+            if (runtime() > maxRunTime) {
+                break;
+            }
+            int iterateCount = 0;
+            vector<int> bestSample;
+            int bestScore = -1;
+            int bestLength = -1;
+            int startTime = runtime();
+            bool repeat = false;
+            while (iterateCount == 0 || repeat) {
+                int l1 = runtime();
+                //每个线程一个候选
+                int screenFactor = USE_SURROGATE && surrogate.sampleCount >= SURROGATE_MIN_TRAINING
+                                   ? SURROGATE_SCREEN_FACTOR : 1;
+                vector<vector<int>> candidateSamples = myGenerate(curSamples, generateInitLength, candidateEdgeCount,
+                                                                  getPool().size() * screenFactor);
+                if (candidateSamples.empty()) {
+                    continue;
+                }
+                vector<int> bestSampleIndex = getBestScreenedSample(curSamples, candidateSamples, getPool().size(),
+                                                                    maxRunTime);
+                vector<int> curSample = {candidateSamples[bestSampleIndex[0]].begin(),
+                                         candidateSamples[bestSampleIndex[0]].begin() +
+                                         bestSampleIndex[1]};
+                int curScore = bestSampleIndex[2];
+                int curLength = bestSampleIndex[3];
+                if (curScore > bestScore) {
+                    bestSample = curSample;
+                    bestScore = curScore;
+                    bestLength = curLength;
+                }
+                iterateCount++;
+                int r1 = runtime();
+                repeat = iterateCount < candidateSampleCount &&
+                         oneMaxRunTime - (runtime() - startTime) - (r1 - l1) > 0;
+            }
+
+            curSamples.push_back(bestSample);
+            results.push_back({bestScore, bestLength, bestSample});
+            int totalValue = 0;
+            for (const SampleResult &result: results) {
+                totalValue += result.value;
+            }
+        }
+        sort(results.begin(), results.end());
+    }
+
+    //按createScores从分最高的几条边里随机挑一条，不在sample里
+    int pickSampleEdge(const vector<char> &inSample, int candidateEdgeSize) {
+        struct EdgeIdScore {
+            int id;
+            int score;
+
+            bool operator<(const EdgeIdScore &o1) const {
+                return score > o1.score;
+            }
+        };
+        priority_queue<EdgeIdScore> minScoreQ;
+        for (int j = 1; j < edges.size(); j++) {
+            if (inSample[j]) {
+                continue;
+            }
+            if (minScoreQ.size() < candidateEdgeSize) {
+                minScoreQ.push({j, createScores[j]});
+            } else if (createScores[j] > minScoreQ.top().score) {
+                minScoreQ.pop();
+                minScoreQ.push({j, createScores[j]});
+            }
+        }
+        if (minScoreQ.empty()) {
+            return -1;
+        }
+        int index = int(createSampleRad() % minScoreQ.size());
+        for (int j = 0; j < index; j++) {
+            minScoreQ.pop();
+        }
+        return minScoreQ.top().id;
+    }
+
+    int tournamentSelect(const vector<SampleResult> &results, int excludeIndex) {
+        int best = -1;
+        for (int i = 0; i < GENETIC_TOURNAMENT_SIZE; i++) {
+            int index = int(createSampleRad() % results.size());
+            if (index == excludeIndex) {
+                continue;
+            }
+            if (best == -1 || results[index].value > results[best].value) {
+                best = index;
+            }
+        }
+        return best == -1 ? (excludeIndex + 1) % int(results.size()) : best;
+    }
+
+    //子代的前缀：第一个父代的前缀接第二个父代的一段，去重，再替换几条边；后面由myGenerate贪心接上
+    vector<int> crossoverSamples(const vector<int> &first, const vector<int> &second) {
+        vector<char> inSample(edges.size());
+        vector<int> child;
+        int firstCut = int(createSampleRad() % (first.size() + 1));
+        int secondBegin = int(createSampleRad() % (second.size() + 1));
+        int secondEnd = secondBegin + int(createSampleRad() % (second.size() - secondBegin + 1));
+        for (int i = 0; i < firstCut; i++) {
+            inSample[first[i]] = true;
+            child.push_back(first[i]);
+        }
+        for (int i = secondBegin; i < secondEnd && child.size() < EVERY_SCENE_MAX_FAIL_EDGE_COUNT; i++) {
+            if (!inSample[second[i]]) {
+                inSample[second[i]] = true;
+                child.push_back(second[i]);
+            }
+        }
+        int mutationCount = child.empty() ? 1 : 1 + int(createSampleRad() % GENETIC_MUTATION_COUNT);
+        for (int i = 0; i < mutationCount; i++) {
+            int id = pickSampleEdge(inSample, CREATE_OPTIMIZE_EDGE_CANDIDATE_COUNT);
+            if (id == -1) {
+                break;
+            }
+            inSample[id] = true;
+            if (child.empty() || (child.size() < EVERY_SCENE_MAX_FAIL_EDGE_COUNT && createSampleRad() % 2 == 0)) {
+                child.insert(child.begin() + createSampleRad() % (child.size() + 1), id);
+            } else {
+                int index = int(createSampleRad() % child.size());
+                inSample[child[index]] = false;
+                child[index] = id;
+            }
+        }
+        return child;
+    }
+
+    struct SampleStatistics {
+        long long generations;//进化代数
+        long long offspring;//评估的子代数
+        long long replacements;//替换最差个体的次数
+        int value;//最终样例集合的价值
+    };
+
+    SampleStatistics sampleStatistics{};
+
+    //稳态进化：种群就是当前的样例集合，每代每个线程一个子代，交叉加变异或者新生成，
+    //和去掉最差个体的其他样例一起并行评估，相似度约束在评估里按前缀检查，比最差的好就替换
+    void evolveSamples(vector<SampleResult> &results) {
+        int staleGenerations = 0;
+        while (staleGenerations < GENETIC_MAX_STALE_GENERATIONS && runtime() <= CREATE_OPTIMIZE_SAMPLES_MAX_TIME) {
+            int minIndex = 0;
+            int minSampleLength = int(results[0].sample.size());
+            int maxSampleLength = int(results[0].sample.size());
+            for (int i = 1; i < results.size(); i++) {
+                if (results[i].value < results[minIndex].value) {
+                    minIndex = i;
+                }
+                minSampleLength = min(minSampleLength, int(results[i].sample.size()));
+                maxSampleLength = max(maxSampleLength, int(results[i].sample.size()));
+            }
+            vector<vector<int>> otherSamples;
+            for (int i = 0; i < results.size(); i++) {
+                if (i != minIndex) {
+                    otherSamples.push_back(results[i].sample);
+                }
+            }
+            int screenFactor = USE_SURROGATE && surrogate.sampleCount >= SURROGATE_MIN_TRAINING
+                               ? SURROGATE_SCREEN_FACTOR : 1;
+            vector<vector<int>> candidateSamples;
+            while (candidateSamples.size() < getPool().size() * screenFactor) {
+                int curCreateLength = min(EVERY_SCENE_MAX_FAIL_EDGE_COUNT, minSampleLength
+                                          + int(createSampleRad() % (maxSampleLength - minSampleLength + 2)));
+                vector<int> prefix;
+                if (results.size() >= 3 && createSampleRad() % 100 >= GENETIC_IMMIGRANT_PERCENT) {
+                    int first = tournamentSelect(results, minIndex);
+                    int second = tournamentSelect(results, minIndex);
+                    prefix = crossoverSamples(results[first].sample, results[second].sample);
+                    curCreateLength = max(curCreateLength, int(prefix.size()));
+                }
+                vector<vector<int>> generated = myGenerate(otherSamples, curCreateLength,
+                                                           CREATE_OPTIMIZE_EDGE_CANDIDATE_COUNT, 1, prefix);
+                if (generated.empty()) {
+                    break;
+                }
+                candidateSamples.push_back(generated[0]);
+            }
+            if (candidateSamples.empty()) {
+                break;
+            }
+            vector<int> bestSampleIndex = getBestScreenedSample(otherSamples, candidateSamples, getPool().size(),
+                                                                CREATE_OPTIMIZE_SAMPLES_MAX_TIME);
+            sampleStatistics.generations++;
+            sampleStatistics.offspring += candidateSamples.size();
+            int bestIndex = bestSampleIndex[0];
+            if (bestIndex != -1 && bestSampleIndex[1] > 0 && bestSampleIndex[2] > results[minIndex].value) {
+                results[minIndex] = {bestSampleIndex[2], bestSampleIndex[3],
+                                     {candidateSamples[bestIndex].begin(),
+                                      candidateSamples[bestIndex].begin() + bestSampleIndex[1]}};
+                sampleStatistics.replacements++;
+                staleGenerations = 0;
+            } else {
+                staleGenerations++;
+            }
+        }
+    }
+
+    int optimizeSamples(vector<SampleResult> &results) {
+        if (results.empty()) {
+            return 0;
+        }
+        evolveSamples(results);
+
+        //重新基础规划
+        int bestValue = 0;
+        for (const SampleResult &result: results) {
+            bestValue += result.value;
+        }
+        sort(results.begin(), results.end());
+
+        vector<SampleResult> bestResult = results;
+        for (int i = 1; i < bestResult.size(); i++) {
+            int initLength = EVERY_SCENE_MAX_FAIL_EDGE_COUNT;
+            //int popCount = int(createSampleRad() % 2) == 0 ? 1 : 2;
+            int popCount = 1;
+            vector<SampleResult> curResults = bestResult;
+            for (int j = 0; j <= popCount; j++) {
+                curResults.pop_back();
+            }
+
+            createBaseSamples(curResults, CREATE_OPTIMIZE_SAMPLE_CANDIDATE_COUNT, CREATE_OPTIMIZE_SAMPLES_MAX_TIME,
+                              CREATE_OPTIMIZE_EDGE_CANDIDATE_COUNT, initLength);
+            if (curResults.size() < bestResult.size()) {
+                //超时结束了
+                break;
+            }
+            int newValue = optimizeSamples(curResults);
+            if (newValue > bestValue) {
+                bestResult = curResults;
+                bestValue = newValue;
+            }
+            if (runtime() > CREATE_OPTIMIZE_SAMPLES_MAX_TIME) {
+                break;
+            }
+        }
+        results.swap(bestResult);
+        return bestValue;
+    }
+
+    //断边推测：等待下一条断边输入时，后台线程在克隆上提前调度最可能断的边，猜中直接输出
+    struct SpeculationStatistics {
+        long long started;//启动推测次数
+        long long hits;//猜中并且算完了，直接输出
+        long long unfinishedHits;//猜中了但是没算完
+        long long misses;//没猜中
+    };
+
+    struct SpeculationContext {
+        thread worker;
+        atomic<bool> cancelled{false};
+        vector<shared_ptr<Strategy>> clones;//每个推测一个克隆，重复使用，只同步变化的部分
+        vector<vector<vector<Point>>> busesResults;//克隆上调度之后的业务路径
+        vector<int> predictedEdgeIds;
+        vector<bool> finished;
+        SpeculationStatistics statistics{};
+    };
+
+    shared_ptr<SpeculationContext> speculation;//只有主对象有，克隆上为空
+    Deadline searchDeadline;//dispatch设置截止时间，推测的克隆还带取消标记
+
+    inline bool isCancelled() {
+        return searchDeadline.check();
+    }
+
+    DispatchDecision lastDecision;//最近一次dispatch的决定，跟着lastDispatchResult一起交换
+    const DispatchDecision *forcedDecision = nullptr;//重放时设，dispatch照着做
+    bool replaying = false;//重放模式，不分配变通道能力，不推测
+    bool useCapabilitySearch = USE_CAPABILITY_SEARCH;//检查并行结果能不能复现时关掉，它受时间影响
+
+    //从另一个对象同步调度会改的状态，边只拷贝内容变了的
+    void syncDispatchStateFrom(const Strategy &o) {
+        for (int i = 1; i < edges.size(); i++) {
+            const Edge &other = o.edges[i];
+            if (edges[i].generation != other.generation || edges[i].die != other.die
+                || memcmp(edges[i].channel, other.channel, sizeof(other.channel)) != 0
+                || !edges[i].sameLives(other)) {
+                edges[i] = other;
+            }
+        }
+        vertices = o.vertices;
+        vertexStates = o.vertexStates;
+        buses = o.buses;
+        searchGraph.rotations = o.searchGraph.rotations;
+        searchRad = o.searchRad;
+        curHandleCount = o.curHandleCount;
+        remainResource = o.remainResource;
+        remainEdgeValue = o.remainEdgeValue;
+        remainEdgeSize = o.remainEdgeSize;
+        curAffectEdgeValue = o.curAffectEdgeValue;
+        timeBudget = o.timeBudget;
+    }
+
+    //和另一个对象交换调度会改的状态，推测猜中时把克隆的结果拿过来
+    void swapDispatchState(Strategy &o) {
+        edges.swap(o.edges);
+        vertices.swap(o.vertices);
+        swap(vertexStates, o.vertexStates);
+        buses.swap(o.buses);
+        searchGraph.rotations.swap(o.searchGraph.rotations);
+        swap(searchRad, o.searchRad);
+        swap(curHandleCount, o.curHandleCount);
+        swap(remainResource, o.remainResource);
+        swap(remainEdgeValue, o.remainEdgeValue);
+        swap(remainEdgeSize, o.remainEdgeSize);
+        swap(curAffectEdgeValue, o.curAffectEdgeValue);
+        swap(timeBudget, o.timeBudget);
+        lastDispatchResult.swap(o.lastDispatchResult);
+        swap(lastDecision, o.lastDecision);
+    }
+
+    //推测下一条断边，自己的样例直接按序列，否则按边上存活业务价值，再按createScores
+    vector<int> predictNextFailEdges(const vector<int> *knownSample, int curLength) {
+        vector<int> result;
+        if (knownSample != nullptr && curLength < knownSample->size()) {
+            result.push_back((*knownSample)[curLength]);
+        }
+        vector<pair<int, int>> liveValues;
+        for (int i = 1; i < edges.size(); i++) {
+            if (edges[i].die) {
+                continue;
+            }
+            int value = edges[i].liveValue;
+            if (value > 0) {
+                liveValues.emplace_back(value, i);
+            }
+        }
+        sort(liveValues.begin(), liveValues.end(), [&](const pair<int, int> &a, const pair<int, int> &b) {
+            if (a.first != b.first) {
+                return a.first > b.first;
+            }
+            return createScores[a.second] > createScores[b.second];
+        });
+        for (const auto &item: liveValues) {
+            if (result.size() >= SPECULATION_EDGE_COUNT) {
+                break;
+            }
+            if (find(result.begin(), result.end(), item.second) == result.end()) {
+                result.push_back(item.second);
+            }
+        }
+        return result;
+    }
+
+    //开始推测，参数和收到断边后调用dispatch的一样
+    void startSpeculation(const vector<vector<Point>> &curBusesResult, const vector<int> *knownSample,
+                          int maxLength, int curLength, bool test) {
+        if (!USE_SPECULATION) {
+            return;
+        }
+        if (!speculation) {
+            speculation = make_shared<SpeculationContext>();
+        }
+        SpeculationContext &context = *speculation;
+        context.cancelled = false;
+        context.predictedEdgeIds.clear();
+        context.finished.assign(SPECULATION_EDGE_COUNT, false);
+        context.busesResults.resize(SPECULATION_EDGE_COUNT);
+        context.statistics.started++;
+        //主线程阻塞在输入上，这期间推测线程可以读主对象
+        context.worker = thread([this, &curBusesResult, knownSample, maxLength, curLength, test]() {
+            SpeculationContext &context = *speculation;
+            vector<int> predicted = predictNextFailEdges(knownSample, curLength);
+            context.predictedEdgeIds = predicted;
+            for (int k = 0; k < predicted.size(); k++) {
+                if (context.cancelled) {
+                    break;
+                }
+                if (context.clones.size() <= k) {
+                    context.clones.push_back(makeClone());
+                }
+                Strategy &clone = *context.clones[k];
+                clone.syncDispatchStateFrom(*this);
+                clone.searchDeadline.cancelFlag = &context.cancelled;
+                context.busesResults[k] = curBusesResult;
+                clone.dispatch(context.busesResults[k], predicted[k], maxLength, curLength + 1, false, test);
+                context.finished[k] = !context.cancelled;
+            }
+        });
+    }
+
+    inline void stopSpeculation() {
+        if (speculation && speculation->worker.joinable()) {
+            speculation->cancelled = true;
+            speculation->worker.join();
+        }
+    }
+
+    //猜中且算完了就把克隆的状态换过来
+    bool applySpeculation(int failEdgeId, vector<vector<Point>> &curBusesResult) {
+        if (!USE_SPECULATION || !speculation) {
+            return false;
+        }
+        SpeculationContext &context = *speculation;
+        for (int k = 0; k < context.predictedEdgeIds.size(); k++) {
+            if (context.predictedEdgeIds[k] != failEdgeId) {
+                continue;
+            }
+            if (!context.finished[k]) {
+                context.statistics.unfinishedHits++;
+                return false;
+            }
+            context.statistics.hits++;
+            swapDispatchState(*context.clones[k]);
+            curBusesResult.swap(context.busesResults[k]);
+            lastDecision.speculated = true;
+            context.finished[k] = false;
+            return true;
+        }
+        context.statistics.misses++;
+        return false;
+    }
+
+    struct PortfolioContext {
+        vector<SearchConfig> configs;//0号是主对象自己的参数
+        vector<long long> runs, wins;//每组参数跑的次数和赢的次数，决定线程给谁
+        vector<shared_ptr<Strategy>> clones;//每个线程一个克隆，重复使用，只同步变化的部分
+        vector<vector<vector<Point>>> busesResults;
+        long long dispatches;
+    };
+
+    shared_ptr<PortfolioContext> portfolio;//只有主对象有，克隆上为空
+
+    //克隆只带调度状态，推测、组合调度、线程池的克隆都不再往下克隆
+    shared_ptr<Strategy> makeClone() const {
+        shared_ptr<Strategy> clone = make_shared<Strategy>(*this);
+        clone->speculation.reset();
+        clone->portfolio.reset();
+        clone->workerClones.clear();
+        return clone;
+    }
+
+    vector<shared_ptr<Strategy>> workerClones;//线程池每个线程一个克隆，0号线程直接用主对象
+
+    //并行阶段开始前把每个线程的克隆同步成主对象的状态
+    void prepareWorkerClones() {
+        int size = getPool().size();
+        while (int(workerClones.size()) < size - 1) {
+            workerClones.push_back(makeClone());
+        }
+        for (const shared_ptr<Strategy> &clone: workerClones) {
+            clone->syncDispatchStateFrom(*this);
+        }
+    }
+
+    inline Strategy &getWorkerStrategy(int worker) {
+        return worker == 0 ? *this : *workerClones[worker - 1];
+    }
+
+    void initPortfolio() {
+        portfolio = make_shared<PortfolioContext>();
+        PortfolioContext &context = *portfolio;
+        const SearchConfig &base = searchConfig;
+        context.configs.push_back(base);
+        SearchConfig config = base;
+        config.otherChangeChannelWeight = base.otherChangeChannelWeight * 2;
+        context.configs.push_back(config);
+        config = base;
+        config.otherChangeChannelWeight = max(1, base.otherChangeChannelWeight / 2);
+        context.configs.push_back(config);
+        config = base;
+        config.otherSearchResourceFactor = base.otherSearchResourceFactor * 1.3;
+        context.configs.push_back(config);
+        config = base;
+        config.otherSearchResourceFactor = base.otherSearchResourceFactor * 0.8;
+        context.configs.push_back(config);
+        config = base;
+        config.needHelpValueMode = 1;
+        context.configs.push_back(config);
+        config = base;
+        config.needHelpValueMode = 2;
+        context.configs.push_back(config);
+        context.runs.assign(context.configs.size(), 0);
+        context.wins.assign(context.configs.size(), 0);
+    }
+
+    //主线程用自己的参数，其他线程按胜率（带先验，没跑过的也有机会）挑参数，各自在克隆上调度，取分最高的
+    void dispatchPortfolio(vector<vector<Point>> &curBusesResult, int failEdgeId, int maxLength, int curLength) {
+        TaskPool &pool = getPool();
+        int threadCount = USE_PORTFOLIO ? pool.size() : 1;
+        if (threadCount <= 1) {
+            dispatch(curBusesResult, failEdgeId, maxLength, curLength, false, false);
+            return;
+        }
+        if (!portfolio) {
+            initPortfolio();
+        }
+        PortfolioContext &context = *portfolio;
+        context.dispatches++;
+        vector<int> chosen;
+        for (int i = 1; i < context.configs.size(); i++) {
+            chosen.push_back(i);
+        }
+        sort(chosen.begin(), chosen.end(), [&](int a, int b) {
+            return (context.wins[a] + 1.0) / (context.runs[a] + 2.0) > (context.wins[b] + 1.0) / (context.runs[b] + 2.0);
+        });
+        chosen.resize(min(int(chosen.size()), threadCount - 1));
+        context.busesResults.resize(chosen.size());
+        for (int k = 0; k < chosen.size(); k++) {
+            if (context.clones.size() <= k) {
+                context.clones.push_back(makeClone());
+            }
+            Strategy &clone = *context.clones[k];
+            clone.syncDispatchStateFrom(*this);
+            clone.searchConfig = context.configs[chosen[k]];
+            context.busesResults[k] = curBusesResult;
+        }
+        //0号任务是主对象自己
+        pool.run(int(chosen.size()) + 1, [&](int, int index) {
+            if (index == 0) {
+                dispatch(curBusesResult, failEdgeId, maxLength, curLength, false, false);
+            } else {
+                context.clones[index - 1]->dispatch(context.busesResults[index - 1], failEdgeId, maxLength,
+                                                    curLength, false, false);
+            }
+        });
+        //分一样时主对象优先，少一次交换
+        int winner = -1;
+        double bestScore = getEstimateScore(lastDispatchResult);
+        for (int k = 0; k < chosen.size(); k++) {
+            double score = getEstimateScore(context.clones[k]->lastDispatchResult);
+            if (score > bestScore) {
+                bestScore = score;
+                winner = k;
+            }
+        }
+        context.runs[0]++;
+        for (int k = 0; k < chosen.size(); k++) {
+            context.runs[chosen[k]]++;
+        }
+        if (winner == -1) {
+            context.wins[0]++;
+        } else {
+            context.wins[chosen[winner]]++;
+            swapDispatchState(*context.clones[winner]);
+            curBusesResult.swap(context.busesResults[winner]);
+            lastDecision.configIndex = chosen[winner];
+        }
+    }
+
+    //场景接口，输入输出由调用方负责
+    vector<SampleResult> sampleResults;//自己生成的样例，前面的场景按这个顺序断边
+    int sceneCount = 0;//总场景数
+    int sceneIndex = -1;//当前场景
+    vector<vector<Point>> sceneBusesResult;//当前场景每个业务的路径
+    int sceneLength = 0;//当前场景已经断的边数
+    int maxCurLength = INT_INF;//假设每次断边一样长？？？
+    int judgeLengthSum = 0;//他的场景已经结束的总断边数，用来估计剩余断边数
+    int judgeSceneCount = 0;
+
+    //生成段，返回自己的断边序列
+    vector<int> getChangeCounts() const override {
+        vector<int> result;
+        for (int i = 1; i < vertices.size(); i++) {
+            result.push_back(vertices[i].maxChangeCount);
+        }
+        return result;
+    }
+
+    vector<vector<int>> createSamples() override {
+        //1.选定最好生成策略
+        sampleResults.clear();
+        createBaseSamples(sampleResults, CREATE_BASE_SAMPLE_CANDIDATE_COUNT, CREATE_BASE_SAMPLES_MAX_TIME,
+                          CREATE_BASE_EDGE_CANDIDATE_COUNT,
+                          EVERY_SCENE_MAX_FAIL_EDGE_COUNT);
+        sampleStatistics.value = optimizeSamples(sampleResults);
+        vector<vector<int>> curSamples;
+        for (const SampleResult &result: sampleResults) {
+            curSamples.push_back(result.sample);
+        }
+        return curSamples;
+    }
+
+    void beginScenarios(int count) override {
+        //线上从空的路径缓存开始，样例生成留下的缓存会让代价相同的路径选得不一样，记录下来也重放不出来
+        pathCache.clear();
+        sceneCount = count;
+        sceneIndex = -1;
+        resultScore[0] = 10000.0 * count;
+        resultScore[1] = 0;
+        maxCurLength = INT_INF;
+        judgeLengthSum = 0;
+        judgeSceneCount = 0;
+    }
+
+    void beginScenario() override {
+        sceneIndex++;
+        sceneBusesResult = busesOriginResult;
+        sceneLength = 0;
+        updateRemainEventCount();
+    }
+
+    inline bool isOwnScene() const {
+        return sceneIndex < sampleResults.size();
+    }
+
+    inline int getSceneMaxLength() const {
+        if (isOwnScene()) {
+            return sampleResults[sceneIndex].maxLength;
+        }
+        //min(int(edges.size()) / 5, EVERY_SCENE_MAX_FAIL_EDGE_COUNT) 3-5
+        return min(maxCurLength, min(int(edges.size()) / 5, EVERY_SCENE_MAX_FAIL_EDGE_COUNT));
+    }
+
+    void updateRemainEventCount() {
+        if (isOwnScene()) {
+            return;
+        }
+        //先验按最长算，再用已经结束的场景修正
+        int maxSceneLength = min(int(edges.size()) / 5, EVERY_SCENE_MAX_FAIL_EDGE_COUNT);
+        double expectLength = 1.0 * (maxSceneLength + judgeLengthSum) / (1 + judgeSceneCount);
+        timeBudget.remainEventCount = max(1, int(round(expectLength)) - sceneLength)
+                                      + int(round((sceneCount - sceneIndex - 1) * expectLength));
+    }
+
+    //等待下一条断边的时候调用，后台推测
+    void startIdleWork() override {
+        startSpeculation(sceneBusesResult, isOwnScene() ? &sampleResults[sceneIndex].sample : nullptr,
+                         getSceneMaxLength(), sceneLength, isOwnScene());
+    }
+
+    void stopIdleWork() override {
+        stopSpeculation();
+    }
+
+    //处理一条断边，返回重新规划的业务路径
+    const unordered_map<int, vector<Point>> &failEdge(int failEdgeId) override {
+        sceneLength++;
+        if (!applySpeculation(failEdgeId, sceneBusesResult)) {
+            if (isOwnScene()) {
+                dispatch(sceneBusesResult, failEdgeId, getSceneMaxLength(), sceneLength, false, true);
+            } else {
+                dispatchPortfolio(sceneBusesResult, failEdgeId, getSceneMaxLength(), sceneLength);
+            }
+        }
+        updateRemainEventCount();
+        return lastDispatchResult;
+    }
+
+    //重放：init之前设，候选路径按记录的业务数建，不做变通道能力搜索
+    void setReplay() override {
+        replaying = true;
+    }
+
+    void setCandidateRouteBusinessCount(int count) override {
+        candidateRouteBusinessCount = count;
+    }
+
+    int getCandidateRouteBusinessCount() const override {
+        return candidateRouteBusinessCount;
+    }
+
+    void setCapabilitySearch(bool enabled) override {
+        useCapabilitySearch = enabled;
+    }
+
+    void setIncrementalSearch(bool enabled) override {
+        incrementalSearchEnabled = USE_INCREMENTAL_SEARCH && enabled;
+    }
+
+    //init之前设，克隆跟着主对象
+    void setPathCache(bool enabled) override {
+        usePathCache = USE_PATH_CACHE && enabled;
+    }
+
+    //init里并行算出来的结果：变通道能力、每条边的打分和影响列表，线程数不同也应该一样
+    unsigned long long getInitHash() const override {
+        unsigned long long hash = 14695981039346656037ULL;
+        for (int i = 1; i <= N; i++) {
+            fnvHash(hash, vertices[i].maxChangeCount);
+        }
+        for (int i = 1; i <= M; i++) {
+            fnvHash(hash, createScores[i]);
+            const vector<vector<int>> *lists[3] = {&baseRepValue[i], &meRepValue[i], &baseOriginValue[i]};
+            for (const vector<vector<int>> *list: lists) {
+                fnvHash(hash, int(list->size()));
+                for (const vector<int> &item: *list) {
+                    fnvHash(hash, item[0]);
+                    fnvHash(hash, item[1]);
+                }
+            }
+        }
+        return hash;
+    }
+
+    vector<int> getSampleMaxLengths() const override {
+        vector<int> result;
+        for (const SampleResult &sampleResult: sampleResults) {
+            result.push_back(sampleResult.maxLength);
+        }
+        return result;
+    }
+
+    //代替createSamples，直接用记录的变通道能力和样例
+    void loadSamples(const SampleSet &sampleSet) override {
+        for (int i = 1; i < vertices.size() && i <= sampleSet.changeCounts.size(); i++) {
+            vertices[i].maxChangeCount = sampleSet.changeCounts[i - 1];
+            vertexStates.changeCounts[i] = vertices[i].maxChangeCount;
+        }
+        sampleResults.clear();
+        for (int i = 0; i < sampleSet.samples.size(); i++) {
+            sampleResults.push_back({0, sampleSet.maxLengths[i], sampleSet.samples[i]});
+        }
+    }
+
+    const DispatchDecision &getLastDecision() const override {
+        return lastDecision;
+    }
+
+    //和failEdge一样，只是不用推测，组合调度直接用记录里赢的那组参数
+    const unordered_map<int, vector<Point>> &replayFailEdge(int failEdgeId,
+                                                            const DispatchDecision &decision) override {
+        sceneLength++;
+        SearchConfig config = searchConfig;
+        if (decision.configIndex > 0) {
+            if (!portfolio) {
+                initPortfolio();
+            }
+            searchConfig = portfolio->configs[decision.configIndex];
+        }
+        forcedDecision = &decision;
+        dispatch(sceneBusesResult, failEdgeId, getSceneMaxLength(), sceneLength, false, isOwnScene());
+        forcedDecision = nullptr;
+        searchConfig = config;
+        lastDecision.configIndex = decision.configIndex;
+        updateRemainEventCount();
+        return lastDispatchResult;
+    }
+
+    unsigned long long getSearchRandomState() const override {
+        stringstream stream;
+        stream << searchRad;
+        unsigned long long state = 0;
+        stream >> state;
+        return state;
+    }
+
+    void setSearchRandomState(unsigned long long state) override {
+        stringstream stream;
+        stream << state;
+        stream >> searchRad;
+    }
+
+    //返回这个场景的得分，存活价值占比乘10000
+    double endScenario() override {
+        if (!isOwnScene()) {
+            judgeLengthSum += sceneLength;
+            judgeSceneCount++;
+            if (maxCurLength != INT_INF) {
+                maxCurLength = max(maxCurLength, sceneLength);
+            } else {
+                maxCurLength = sceneLength;
+            }
+        }
+        int totalValue = 0;
+        int remainValue = 0;
+        for (int j = 1; j < buses.size(); j++) {
+            totalValue += buses[j].value;
+            if (!buses[j].die) {
+                remainValue += buses[j].value;
+            }
+        }
+        double sceneScore = 10000.0 * remainValue / totalValue;
+        resultScore[1] += sceneScore;
+        reset();
+        if (sceneIndex == sceneCount - 1 && PRINT_STATISTICS) {
+            printStatistics();
+        }
+        return sceneScore;
+    }
+};
+
+#endif //STRATEGY_H
@@ -0,0 +1,339 @@
+/*
+ * Description: 线上运行的二进制记录，网络、变通道能力、样例、随机数状态、每条断边的决定和输出，
+ * 整数都按zigzag变长编码，每条断边记完刷一次盘，进程中途退出也能读出前面完整的部分
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "routing_api.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+const unsigned TRACE_MAGIC = 0x54524345;//文件头
+const unsigned TRACE_VERSION = 1;//格式改了要加1
+
+//记录类型
+enum TraceTag {
+    TRACE_NETWORK = 1,
+    TRACE_SAMPLES,
+    TRACE_SCENARIOS,
+    TRACE_SCENE_BEGIN,
+    TRACE_FAIL_EDGE,
+    TRACE_SCENE_END
+};
+
+struct TraceWriter {
+    FILE *file = nullptr;
+    std::vector<unsigned char> buffer;
+
+    bool open(const std::string &path) {
+        file = fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        fwrite(&TRACE_MAGIC, sizeof TRACE_MAGIC, 1, file);
+        writeInt(TRACE_VERSION);
+        flush();
+        return true;
+    }
+
+    ~TraceWriter() {
+        if (file != nullptr) {
+            flush();
+            fclose(file);
+        }
+    }
+
+    void writeInt(long long value) {
+        unsigned long long zigzag = (unsigned long long) (value << 1) ^ (unsigned long long) (value >> 63);
+        while (zigzag >= 0x80) {
+            buffer.push_back((unsigned char) (zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        buffer.push_back((unsigned char) zigzag);
+    }
+
+    void writeState(unsigned long long value) {
+        while (value >= 0x80) {
+            buffer.push_back((unsigned char) (value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((unsigned char) value);
+    }
+
+    void writeArray(const std::vector<int> &values) {
+        writeInt((long long) values.size());
+        for (int value: values) {
+            writeInt(value);
+        }
+    }
+
+    void flush() {
+        fwrite(buffer.data(), 1, buffer.size(), file);
+        fflush(file);
+        buffer.clear();
+    }
+
+    void writeNetwork(const NetworkInput &input, int candidateRouteBusinessCount) {
+        writeInt(TRACE_NETWORK);
+        writeInt(input.channelCount);
+        writeInt(input.vertexCount);
+        writeArray(input.changeCounts);
+        writeInt((long long) input.edges.size());
+        for (const NetworkEdge &edge: input.edges) {
+            writeInt(edge.from);
+            writeInt(edge.to);
+        }
+        writeInt((long long) input.businesses.size());
+        for (const NetworkBusiness &business: input.businesses) {
+            writeInt(business.from);
+            writeInt(business.to);
+            writeInt(business.startChannel);
+            writeInt(business.endChannel);
+            writeInt(business.value);
+            writeArray(business.edgeIds);
+        }
+        writeInt(candidateRouteBusinessCount);
+        flush();
+    }
+
+    void writeSamples(const SampleSet &sampleSet, int createSampleSeed, int searchSeed) {
+        writeInt(TRACE_SAMPLES);
+        writeInt(createSampleSeed);
+        writeInt(searchSeed);
+        writeArray(sampleSet.changeCounts);
+        writeInt((long long) sampleSet.samples.size());
+        for (int i = 0; i < sampleSet.samples.size(); i++) {
+            writeInt(sampleSet.maxLengths[i]);
+            writeArray(sampleSet.samples[i]);
+        }
+        flush();
+    }
+
+    void writeScenarios(int count) {
+        writeInt(TRACE_SCENARIOS);
+        writeInt(count);
+        flush();
+    }
+
+    void writeSceneBegin(unsigned long long searchRandomState) {
+        writeInt(TRACE_SCENE_BEGIN);
+        writeState(searchRandomState);
+    }
+
+    void writeFailEdge(int failEdgeId, const DispatchDecision &decision, long long elapsed,
+                       const ReroutePlan &plan) {
+        writeInt(TRACE_FAIL_EDGE);
+        writeInt(failEdgeId);
+        writeInt(decision.passes);
+        writeInt(decision.heuristicWeight);
+        writeInt(decision.candidateRouteOnly);
+        writeInt(decision.lastPassInterrupted);
+        writeInt(decision.configIndex);
+        writeInt(decision.speculated);
+        writeInt(elapsed);
+        writeInt((long long) plan.size());
+        for (const ReroutedBusiness &business: plan) {
+            writeInt(business.businessId);
+            writeInt((long long) business.segments.size());
+            for (const RouteSegment &segment: business.segments) {
+                writeInt(segment.edgeId);
+                writeInt(segment.startChannel);
+                writeInt(segment.endChannel);
+            }
+        }
+        flush();
+    }
+
+    void writeSceneEnd(double score) {
+        writeInt(TRACE_SCENE_END);
+        writeInt((long long) (score * 1000 + 0.5));
+        flush();
+    }
+};
+
+struct TraceEvent {
+    int failEdgeId;
+    DispatchDecision decision;
+    long long elapsed;//记录时这条断边用的时间(us)
+    ReroutePlan plan;
+};
+
+struct TraceScene {
+    unsigned long long searchRandomState;
+    std::vector<TraceEvent> events;
+    bool finished;
+    double score;
+};
+
+struct Trace {
+    NetworkInput input;
+    int candidateRouteBusinessCount = -1;
+    bool hasSamples = false;
+    int createSampleSeed = 0;
+    int searchSeed = 0;
+    SampleSet sampleSet;
+    int scenarioCount = 0;
+    std::vector<TraceScene> scenes;
+};
+
+//按顺序读变长整数，越界以后一直失败
+struct TraceReader {
+    const unsigned char *data;
+    size_t size;
+    size_t position;
+    bool failed;
+
+    unsigned long long readState() {
+        unsigned long long value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position >= size) {
+                failed = true;
+                return 0;
+            }
+            unsigned char byte = data[position++];
+            value |= (unsigned long long) (byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+        failed = true;
+        return 0;
+    }
+
+    long long readInt() {
+        unsigned long long zigzag = readState();
+        return (long long) (zigzag >> 1) ^ -(long long) (zigzag & 1);
+    }
+
+    //元素个数，每个元素至少一个字节，超过剩下的字节数就是坏了
+    size_t readCount() {
+        long long count = readInt();
+        if (count < 0 || count > (long long) (size - position)) {
+            failed = true;
+            return 0;
+        }
+        return size_t(count);
+    }
+
+    void readArray(std::vector<int> &values) {
+        values.resize(readCount());
+        for (int &value: values) {
+            value = int(readInt());
+        }
+    }
+};
+
+//读到文件尾或者最后一条不完整的记录为止，文件头或者网络读不出来返回false
+inline bool readTrace(const std::string &path, Trace &trace) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::vector<unsigned char> data;
+    unsigned char chunk[1 << 16];
+    size_t count;
+    while ((count = fread(chunk, 1, sizeof chunk, file)) > 0) {
+        data.insert(data.end(), chunk, chunk + count);
+    }
+    fclose(file);
+    unsigned magic = 0;
+    if (data.size() < sizeof magic) {
+        return false;
+    }
+    memcpy(&magic, data.data(), sizeof magic);
+    TraceReader reader{data.data(), data.size(), sizeof magic, false};
+    if (magic != TRACE_MAGIC || reader.readInt() != TRACE_VERSION) {
+        return false;
+    }
+    bool hasNetwork = false;
+    while (reader.position < reader.size) {
+        long long tag = reader.readInt();
+        if (tag == TRACE_NETWORK) {
+            NetworkInput &input = trace.input;
+            input.channelCount = int(reader.readInt());
+            input.vertexCount = int(reader.readInt());
+            reader.readArray(input.changeCounts);
+            input.edges.resize(reader.readCount());
+            for (NetworkEdge &edge: input.edges) {
+                edge.from = int(reader.readInt());
+                edge.to = int(reader.readInt());
+            }
+            input.businesses.resize(reader.readCount());
+            for (NetworkBusiness &business: input.businesses) {
+                business.from = int(reader.readInt());
+                business.to = int(reader.readInt());
+                business.startChannel = int(reader.readInt());
+                business.endChannel = int(reader.readInt());
+                business.value = int(reader.readInt());
+                reader.readArray(business.edgeIds);
+            }
+            trace.candidateRouteBusinessCount = int(reader.readInt());
+            hasNetwork = !reader.failed;
+        } else if (tag == TRACE_SAMPLES) {
+            SampleSet sampleSet;
+            trace.createSampleSeed = int(reader.readInt());
+            trace.searchSeed = int(reader.readInt());
+            reader.readArray(sampleSet.changeCounts);
+            size_t sampleCount = reader.readCount();
+            for (size_t i = 0; i < sampleCount && !reader.failed; i++) {
+                sampleSet.maxLengths.push_back(int(reader.readInt()));
+                sampleSet.samples.emplace_back();
+                reader.readArray(sampleSet.samples.back());
+            }
+            if (!reader.failed) {
+                trace.sampleSet = sampleSet;
+                trace.hasSamples = true;
+            }
+        } else if (tag == TRACE_SCENARIOS) {
+            trace.scenarioCount = int(reader.readInt());
+        } else if (tag == TRACE_SCENE_BEGIN) {
+            TraceScene scene{reader.readState(), {}, false, 0};
+            if (!reader.failed) {
+                trace.scenes.push_back(scene);
+            }
+        } else if (tag == TRACE_FAIL_EDGE && !trace.scenes.empty()) {
+            TraceEvent event;
+            event.failEdgeId = int(reader.readInt());
+            event.decision.passes = int(reader.readInt());
+            event.decision.heuristicWeight = int(reader.readInt());
+            event.decision.candidateRouteOnly = reader.readInt() != 0;
+            event.decision.lastPassInterrupted = reader.readInt() != 0;
+            event.decision.configIndex = int(reader.readInt());
+            event.decision.speculated = reader.readInt() != 0;
+            event.elapsed = reader.readInt();
+            size_t businessCount = reader.readCount();
+            for (size_t i = 0; i < businessCount && !reader.failed; i++) {
+                ReroutedBusiness business{int(reader.readInt()), {}};
+                size_t segmentCount = reader.readCount();
+                for (size_t j = 0; j < segmentCount && !reader.failed; j++) {
+                    RouteSegment segment{};
+                    segment.edgeId = int(reader.readInt());
+                    segment.startChannel = int(reader.readInt());
+                    segment.endChannel = int(reader.readInt());
+                    business.segments.push_back(segment);
+                }
+                event.plan.push_back(business);
+            }
+            if (!reader.failed) {
+                trace.scenes.back().events.push_back(event);
+            }
+        } else if (tag == TRACE_SCENE_END && !trace.scenes.empty()) {
+            long long score = reader.readInt();
+            if (!reader.failed) {
+                trace.scenes.back().finished = true;
+                trace.scenes.back().score = score / 1000.0;
+            }
+        } else {
+            break;
+        }
+        if (reader.failed) {
+            break;
+        }
+    }
+    return hasNetwork;
+}
+
+#endif //TRACE_H